@@ -0,0 +1,221 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file arena.hpp
+ * @brief Implementation of monotonic and pooled memory arenas and an allocator drawing from them.
+ */
+
+#ifndef CPP_ARENA_H_
+#define CPP_ARENA_H_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+
+/**
+ * @brief Monotonic memory arena, releasing memory only all at once.
+ *
+ * Deallocations are no-ops, while `reset` makes all memory reusable without returning it
+ * to the system, so that repeated computations of similar size perform no heap allocations.
+ * Not thread-safe: a separate arena should be used by every worker.
+ */
+class monotonic_arena {
+  public:
+    //! @brief construction given the size of the first block
+    monotonic_arena(size_t initial = 1 << 16) : m_initial(initial) {}
+
+    //! @brief not copyable (allocators point to it)
+    //! @{
+    monotonic_arena(const monotonic_arena&) = delete;
+
+    monotonic_arena& operator=(const monotonic_arena&) = delete;
+    //! @}
+
+    //! @brief allocates a number of bytes with a given alignment
+    void* allocate(size_t n, size_t align) {
+        while (m_block < m_blocks.size()) {
+            char* p = align_up(m_blocks[m_block].first.get() + m_used, align);
+            if (p + n <= m_blocks[m_block].first.get() + m_blocks[m_block].second) {
+                m_used = p + n - m_blocks[m_block].first.get();
+                return p;
+            }
+            ++m_block;
+            m_used = 0;
+        }
+        size_t size = std::max(m_blocks.empty() ? m_initial : 2*m_blocks.back().second, n + align);
+        m_blocks.emplace_back(std::unique_ptr<char[]>(new char[size]), size);
+        char* p = align_up(m_blocks.back().first.get(), align);
+        m_used = p + n - m_blocks.back().first.get();
+        return p;
+    }
+
+    //! @brief deallocation is deferred to the next reset
+    void deallocate(void*, size_t) {}
+
+    //! @brief makes all memory available again (invalidating previous allocations)
+    void reset() {
+        m_block = m_used = 0;
+    }
+
+    //! @brief total number of bytes held by the arena
+    size_t capacity() const {
+        size_t c = 0;
+        for (const auto& b : m_blocks) c += b.second;
+        return c;
+    }
+
+  private:
+    //! @brief rounds a pointer up to a given alignment
+    static char* align_up(char* p, size_t align) {
+        return p + (align - reinterpret_cast<uintptr_t>(p) % align) % align;
+    }
+
+    //! @brief size of the first block
+    size_t m_initial;
+    //! @brief memory blocks with their sizes
+    std::vector<std::pair<std::unique_ptr<char[]>, size_t>> m_blocks;
+    //! @brief index of the block in use
+    size_t m_block = 0;
+    //! @brief bytes used in the block in use
+    size_t m_used = 0;
+};
+
+
+/**
+ * @brief Memory arena recycling freed chunks by size class, drawing new chunks from a monotonic arena.
+ *
+ * Sizes are rounded up to powers of two, and freed chunks are kept in a list for their class,
+ * so that buffers released while containers grow (or shrink, as deques do) are reused by later
+ * requests instead of accumulating until `reset`. Chunks larger than a threshold are few (as
+ * containers grow geometrically) and are left to the system allocator, so that they are returned
+ * to the system as soon as they are freed. Not thread-safe: a separate arena should be used by
+ * every worker.
+ */
+class pool_arena {
+  public:
+    //! @brief construction given the size of the first block of the underlying monotonic arena, and the size of chunks left to the system
+    pool_arena(size_t initial = 1 << 16, size_t large = 1 << 16) : m_arena(initial), m_large(size_class(large)) {
+        m_free.fill(nullptr);
+    }
+
+    //! @brief not copyable (allocators point to it)
+    //! @{
+    pool_arena(const pool_arena&) = delete;
+
+    pool_arena& operator=(const pool_arena&) = delete;
+    //! @}
+
+    //! @brief allocates a number of bytes with a given alignment (at most that of `std::max_align_t`)
+    void* allocate(size_t n, size_t align) {
+        assert(align <= alignof(std::max_align_t));
+        size_t c = size_class(n);
+        if (c >= m_large) return ::operator new(n);
+        if (chunk* p = m_free[c]) {
+            m_free[c] = p->next;
+            return p;
+        }
+        return m_arena.allocate(size_t(1) << c, alignof(std::max_align_t));
+    }
+
+    //! @brief makes a chunk of a number of bytes available for later requests of the same class
+    void deallocate(void* p, size_t n) {
+        size_t c = size_class(n);
+        if (c >= m_large) ::operator delete(p);
+        else m_free[c] = new (p) chunk{m_free[c]};
+    }
+
+    //! @brief makes all memory available again (invalidating previous allocations)
+    void reset() {
+        m_free.fill(nullptr);
+        m_arena.reset();
+    }
+
+    //! @brief total number of bytes held by the arena (excluding chunks left to the system)
+    size_t capacity() const {
+        return m_arena.capacity();
+    }
+
+  private:
+    //! @brief A freed chunk.
+    struct chunk {
+        //! @brief the next freed chunk of the same class
+        chunk* next;
+    };
+
+    //! @brief the binary logarithm of the smallest power of two holding a number of bytes (and a chunk)
+    static size_t size_class(size_t n) {
+        size_t c = 0;
+        while ((size_t(1) << c) < std::max(n, sizeof(chunk))) ++c;
+        return c;
+    }
+
+    //! @brief the underlying arena
+    monotonic_arena m_arena;
+    //! @brief the first size class left to the system
+    size_t m_large;
+    //! @brief lists of freed chunks for every size class
+    std::array<chunk*, 8*sizeof(size_t)> m_free;
+};
+
+
+/**
+ * @brief Allocator drawing memory from an arena.
+ *
+ * @param R The arena type (`monotonic_arena` or `pool_arena`).
+ */
+template <typename T, typename R = monotonic_arena>
+class arena_allocator {
+  public:
+    //! @brief type of the elements allocated
+    using value_type = T;
+
+    //! @brief construction
+    //! @{
+    arena_allocator(R& arena) : m_arena(&arena) {}
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U,R>& o) : m_arena(o.arena()) {}
+    //! @}
+
+    //! @brief allocates memory for n elements
+    T* allocate(size_t n) {
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    //! @brief returns memory for n elements to the arena
+    void deallocate(T* p, size_t n) {
+        m_arena->deallocate(p, n * sizeof(T));
+    }
+
+    //! @brief the arena used
+    R* arena() const {
+        return m_arena;
+    }
+
+  private:
+    //! @brief the arena used
+    R* m_arena;
+};
+
+
+//! @brief allocators are equal if they share the arena
+//! @{
+template <typename T, typename U, typename R>
+bool operator==(const arena_allocator<T,R>& x, const arena_allocator<U,R>& y) {
+    return x.arena() == y.arena();
+}
+
+template <typename T, typename U, typename R>
+bool operator!=(const arena_allocator<T,R>& x, const arena_allocator<U,R>& y) {
+    return x.arena() != y.arena();
+}
+//! @}
+
+
+#endif // CPP_ARENA_H_
@@ -10,10 +10,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <memory>
 #include <ostream>
 #include <vector>
 
 #include "frac.hpp"
+#include "func_profile.hpp"
 #include "max_deque.hpp"
 #include "sq2.hpp"
 
@@ -24,26 +27,50 @@ constexpr double SS    = 1.414213562373095;
 //! @brief √2 exact.
 const     sq2    S(0,1);
 
-//! @brief Function guiding leader election.
-class func {
+/**
+ * @brief Function guiding leader election.
+ *
+ * Instances are immutable after construction: const member functions can be called
+ * concurrently from any number of threads (see `shared_func` for publishing new versions).
+ *
+ * @param A The allocator used for internal storage (see `arena_allocator` for reusing memory across instances).
+ */
+template <typename A = std::allocator<int>>
+class basic_func {
+    //! @brief the allocator rebound to a given type
+    template <typename T>
+    using alloc_t = typename std::allocator_traits<A>::template rebind_alloc<T>;
+
   public:
     //! @brief fills the function until error or success
-    func(frac mk) : MK(mk) {
+    basic_func(frac mk, const A& alloc = A()) : MK(mk), deltas(alloc_t<sq2>(alloc)), xs(alloc), ys(alloc), cs(alloc) {
         int is = 0;
+        FUNC_PROFILE(m_profile.start();)
         for (int x=0; ; ++x) {
+            FUNC_PROFILE(++m_profile.iterations;)
             cs.push_back(nextconv(is));
             int y = maxallowed(x);
-            if (not emplace(x, y)) break;
+            FUNC_PROFILE(m_profile.lap(func_profile::generation);)
+            if (not emplace(x, y)) {
+                FUNC_PROFILE(m_profile.fail_x = x; m_profile.fail_y = y; m_profile.lap(func_profile::emplacement);)
+                break;
+            }
+            FUNC_PROFILE(m_profile.lap(func_profile::emplacement);)
             assert(is < (int)xs.size());
             deltas.push_back(x+1 - (S-1)*(y+1));
+            FUNC_PROFILE(++m_profile.pushes; m_profile.length(deltas.size());)
             // xs[is] = g^-1(x)
             while (ys[is] < x+1) {
                 for (int i=xs[is]+1; i<=xs[is+1]; ++i) deltas.pop_front();
+                FUNC_PROFILE(m_profile.pops += xs[is+1] - xs[is];)
                 ++is;
             }
+            FUNC_PROFILE(m_profile.lap(func_profile::deltas);)
             // xs[is] = g^-1(x+1)
             sq2 d = std::max(xs[is] - (S-1)*(x+1), deltas.top());
-            if (x + 1 > xlimit(double(d))) {
+            bool success = x + 1 > xlimit(double(d));
+            FUNC_PROFILE(m_profile.lap(func_profile::asymptotic);)
+            if (success) {
                 // generation ends with success
                 alpha = (1-d) * (S+1);
                 break;
@@ -97,6 +124,13 @@ class func {
     size_t size() const {
         return xs.back()+1;
     }
+
+#ifdef FUNC_PROFILING
+    //! @brief statistics on the generation
+    const func_profile& profile() const {
+        return m_profile;
+    }
+#endif
     
   private:
     //! @brief inserts a pair for which func(x) = y (possibly updating backwards to ensure monotonicity)
@@ -116,6 +150,7 @@ class func {
             }
         }
         while (not ys.empty() and ys.back() >= y) {
+            FUNC_PROFILE(++m_profile.backtracks;)
             x = xs.back();
             xs.pop_back();
             ys.pop_back();
@@ -153,18 +188,27 @@ class func {
     //! @brief denominator for computing x0 given delta (depends on K)
     double bf = 0;
     //! @brief deltas of last generated elements
-    max_deque<sq2> deltas;
+    max_deque<sq2, std::less<sq2>, alloc_t<sq2>> deltas;
     //! @brief alpha for generating elements beyond end
     sq2 alpha;
     //! @brief custom values xs -> ys of the function
-    std::vector<int> xs, ys;
+    std::vector<int, alloc_t<int>> xs, ys;
     //! @brief convergence times
-    std::vector<int> cs;
+    std::vector<int, alloc_t<int>> cs;
+#ifdef FUNC_PROFILING
+    //! @brief statistics on the generation
+    func_profile m_profile;
+#endif
 };
 
 
+//! @brief Function guiding leader election, with default allocation.
+using func = basic_func<>;
+
+
 //! @brief printing
-std::ostream& operator<<(std::ostream& o, const func& g) {
+template <typename A>
+std::ostream& operator<<(std::ostream& o, const basic_func<A>& g) {
     for (int x=0; x<200; ++x)
         o << "g(" << x << ") = " << g.dir(x) << (x%10 == 9 ? "\n" : "\t");
     return o;
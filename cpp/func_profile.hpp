@@ -0,0 +1,86 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file func_profile.hpp
+ * @brief Implementation of the func_profile struct collecting statistics on func generation.
+ *
+ * Statistics are collected only if `FUNC_PROFILING` is defined (e.g. `./make.sh run -DFUNC_PROFILING parameter`).
+ */
+
+#ifndef CPP_FUNC_PROFILE_H_
+#define CPP_FUNC_PROFILE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+
+//! @brief Executes its argument only if profiling is enabled.
+#ifdef FUNC_PROFILING
+#define FUNC_PROFILE(...) __VA_ARGS__
+#else
+#define FUNC_PROFILE(...)
+#endif
+
+
+//! @brief Statistics on the generation of a func.
+struct func_profile {
+    //! @brief phases of every generation step
+    enum phase { generation, emplacement, deltas, asymptotic, phases };
+
+    //! @brief name of a phase
+    static const char* name(int p) {
+        static const char* names[phases] = {"generation", "emplacement", "deltas", "asymptotic"};
+        return names[p];
+    }
+
+    //! @brief number of generation steps
+    size_t iterations = 0;
+    //! @brief pairs removed by `emplace` to ensure monotonicity
+    size_t backtracks = 0;
+    //! @brief pushes into the deltas queue
+    size_t pushes = 0;
+    //! @brief pops from the deltas queue
+    size_t pops = 0;
+    //! @brief maximum length of the deltas queue
+    size_t max_length = 0;
+    //! @brief seconds spent in each phase
+    double time[phases] = {};
+    //! @brief the pair (x, y) where generation failed (-1 on success)
+    int fail_x = -1, fail_y = -1;
+
+    //! @brief starts measuring time
+    void start() {
+        m_last = std::chrono::steady_clock::now();
+    }
+
+    //! @brief attributes time since the last call to a phase
+    void lap(phase p) {
+        auto t = std::chrono::steady_clock::now();
+        time[p] += std::chrono::duration<double>(t - m_last).count();
+        m_last = t;
+    }
+
+    //! @brief records the current length of the deltas queue
+    void length(size_t l) {
+        max_length = std::max(max_length, l);
+    }
+
+  private:
+    //! @brief time of the last measurement
+    std::chrono::steady_clock::time_point m_last;
+};
+
+
+//! @brief printing (as a single tab-separated line)
+std::ostream& operator<<(std::ostream& o, const func_profile& p) {
+    o << "iterations " << p.iterations << "\tbacktracks " << p.backtracks << "\tpushes " << p.pushes << "\tpops " << p.pops << "\tlength " << p.max_length;
+    for (int i = 0; i < func_profile::phases; ++i)
+        o << "\t" << func_profile::name(i) << " " << p.time[i] << "s";
+    if (p.fail_x >= 0) o << "\tfailure (" << p.fail_x << ", " << p.fail_y << ")";
+    return o;
+}
+
+
+#endif // CPP_FUNC_PROFILE_H_
@@ -0,0 +1,3 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+#include "cpp/latin_hypercube.hpp"
@@ -0,0 +1,41 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file latin_hypercube.hpp
+ * @brief Implementation of Latin hypercube sampling of the unit cube.
+ */
+
+#ifndef CPP_LATIN_HYPERCUBE_H_
+#define CPP_LATIN_HYPERCUBE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+/**
+ * @brief Latin hypercube sample of `n` points in the unit cube of dimension `D`.
+ *
+ * Every dimension is split into `n` strata of equal width, each containing exactly one point,
+ * so that every parameter is explored uniformly whatever the number of dimensions.
+ */
+template <size_t D>
+std::vector<std::array<double,D>> latin_hypercube(size_t n, uint_fast32_t seed = 0) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> jitter(0, 1);
+    std::vector<std::array<double,D>> points(n);
+    std::vector<size_t> strata(n);
+    for (size_t d = 0; d < D; ++d) {
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), gen);
+        for (size_t i = 0; i < n; ++i)
+            points[i][d] = (strata[i] + jitter(gen)) / n;
+    }
+    return points;
+}
+
+
+#endif // CPP_LATIN_HYPERCUBE_H_
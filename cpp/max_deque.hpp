@@ -9,17 +9,24 @@
 #define CPP_MAX_DEQUE_H_
 
 #include <deque>
+#include <memory>
 #include <ostream>
+#include <utility>
 
 
 //! @brief Deque allowing constant access to maximum element.
-template <typename T, typename C = std::less<T>>
+template <typename T, typename C = std::less<T>, typename A = std::allocator<T>>
 class max_deque {
+    //! @brief type of the items stored
+    using item_type = std::pair<T,size_t>;
+
   public:
     //! @brief construction
     //! @{
     max_deque() = default;
     
+    explicit max_deque(const A& alloc) : m_data(alloc) {}
+    
     template <class I>
     max_deque(I first, I last) {
         for (I it = first; it != last; ++it)
@@ -120,7 +127,7 @@ class max_deque {
 
   private:
     //! @brief candidate maxima with indices
-    std::deque<std::pair<T,size_t>> m_data;
+    std::deque<item_type, typename std::allocator_traits<A>::template rebind_alloc<item_type>> m_data;
     //! @brief virtual index of beginning
     size_t m_begin = 0;
     //! @brief virtual index of end
@@ -131,8 +138,8 @@ class max_deque {
 
 
 //! @brief printing
-template <typename T, typename C>
-std::ostream& operator<<(std::ostream& o, const max_deque<T,C>& q) {
+template <typename T, typename C, typename A>
+std::ostream& operator<<(std::ostream& o, const max_deque<T,C,A>& q) {
     return o << "[" << q.front() << ".." << q.back() << ": T = " << q.top() << "]";
 }
 
@@ -0,0 +1,67 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file phase_timer.hpp
+ * @brief Implementation of the phase_timer class measuring the time spent in the phases of a program.
+ *
+ * Times are written only if the `PHASE_TIMES` environment variable names a file (as in `./make.sh profile`).
+ */
+
+#ifndef CPP_PHASE_TIMER_H_
+#define CPP_PHASE_TIMER_H_
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+
+
+//! @brief Accumulator of the seconds spent in named phases, one phase at a time.
+class phase_timer {
+  public:
+    //! @brief starts measuring a phase (ending the current one)
+    void start(std::string const& name) {
+        stop();
+        m_phase = name;
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    //! @brief ends the current phase (if any)
+    void stop() {
+        if (m_phase.empty()) return;
+        m_time[m_phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        m_phase.clear();
+    }
+
+    //! @brief adds seconds measured elsewhere to a phase (e.g. a part of another phase, timed from within it)
+    void add(std::string const& name, double secs) {
+        m_time[name] += secs;
+    }
+
+    //! @brief seconds spent in a phase so far
+    double time(std::string const& name) const {
+        auto it = m_time.find(name);
+        return it == m_time.end() ? 0 : it->second;
+    }
+
+    //! @brief writes the phase times as "name seconds" lines to the file named by `PHASE_TIMES`
+    ~phase_timer() {
+        stop();
+        char const* file = std::getenv("PHASE_TIMES");
+        if (file == nullptr) return;
+        std::ofstream f(file);
+        for (auto const& p : m_time) f << p.first << " " << p.second << std::endl;
+    }
+
+  private:
+    //! @brief The current phase (empty if none).
+    std::string m_phase;
+    //! @brief Start of the current phase.
+    std::chrono::steady_clock::time_point m_start;
+    //! @brief Seconds spent in each phase.
+    std::map<std::string, double> m_time;
+};
+
+
+#endif // CPP_PHASE_TIMER_H_
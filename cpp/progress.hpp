@@ -0,0 +1,117 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file progress.hpp
+ * @brief Implementation of the progress class reporting on long computations from a background thread.
+ */
+
+#ifndef CPP_PROGRESS_H_
+#define CPP_PROGRESS_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+/**
+ * @brief Reporter of the progress of a computation made of many runs.
+ *
+ * A background thread periodically prints runs done, throughput and estimated time to completion,
+ * and executes a periodic job (e.g. writing partial plots), so that workers only need to call `done`
+ * and never wait for reporting or for output.
+ */
+class progress {
+  public:
+    //! @brief construction given the total number of runs, the reporting interval in seconds and a job to execute after every report
+    progress(size_t total, double interval = 10, std::function<void()> job = nullptr, std::ostream& o = std::cerr) :
+        m_total(total), m_interval(interval), m_job(std::move(job)), m_out(o), m_start(clock_t::now()), m_thread([this](){ loop(); }) {}
+
+    //! @brief not copyable
+    //! @{
+    progress(const progress&) = delete;
+
+    progress& operator=(const progress&) = delete;
+    //! @}
+
+    //! @brief stops the background thread (after a last report)
+    ~progress() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
+    }
+
+    //! @brief records completed runs (from any thread)
+    void done(size_t n = 1) {
+        m_done += n;
+    }
+
+  private:
+    //! @brief the clock used
+    using clock_t = std::chrono::steady_clock;
+
+    //! @brief body of the background thread
+    void loop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            bool stop = m_cv.wait_for(lock, std::chrono::duration<double>(m_interval), [this](){ return m_stop; });
+            lock.unlock();
+            report();
+            if (stop) return;
+            if (m_job) m_job();
+            lock.lock();
+        }
+    }
+
+    //! @brief prints a progress line
+    void report() {
+        size_t done = m_done;
+        double elapsed = std::chrono::duration<double>(clock_t::now() - m_start).count();
+        m_out << "[progress] " << done << "/" << m_total << " runs (" << std::fixed << std::setprecision(1) << 100.0 * done / m_total << "%), ";
+        m_out << done / elapsed << " runs/s, elapsed " << format(elapsed) << ", ETA ";
+        if (done > 0) m_out << format(elapsed * (m_total - done) / done);
+        else m_out << "?";
+        m_out << std::defaultfloat << std::endl;
+    }
+
+    //! @brief formats a number of seconds as hh:mm:ss
+    static std::string format(double s) {
+        long long t = s;
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%02lld:%02lld:%02lld", t / 3600, t / 60 % 60, t % 60);
+        return buf;
+    }
+
+    //! @brief total number of runs
+    size_t m_total;
+    //! @brief runs completed
+    std::atomic<size_t> m_done{0};
+    //! @brief seconds between reports
+    double m_interval;
+    //! @brief job executed after every report (but the last)
+    std::function<void()> m_job;
+    //! @brief stream for reports
+    std::ostream& m_out;
+    //! @brief starting time
+    clock_t::time_point m_start;
+    //! @brief whether the background thread should stop
+    bool m_stop = false;
+    //! @brief mutex protecting the stop flag
+    std::mutex m_mutex;
+    //! @brief condition variable waking up the background thread
+    std::condition_variable m_cv;
+    //! @brief the background thread (started last)
+    std::thread m_thread;
+};
+
+
+#endif // CPP_PROGRESS_H_
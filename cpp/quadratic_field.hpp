@@ -0,0 +1,499 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file quadratic_field.hpp
+ * @brief Implementation of the quadratic_field numeric type representing values of the form (x + √D y) / z.
+ */
+
+#ifndef CPP_QUADRATIC_FIELD_H_
+#define CPP_QUADRATIC_FIELD_H_
+
+#include <cstddef>
+#include <ostream>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+
+//! @brief Whether a number is not divisible by any square (except 1).
+constexpr bool square_free(long long n) {
+    for (long long k = 2; k*k <= n; ++k)
+        if (n % (k*k) == 0) return false;
+    return n > 1;
+}
+
+//! @brief Square root evaluable at compile time (within an ulp of `std::sqrt`).
+constexpr double constexpr_sqrt(long double v) {
+    long double x = v, y = (x + v / x) / 2;
+    while (y < x) {
+        x = y;
+        y = (x + v / x) / 2;
+    }
+    return double(x);
+}
+
+
+/**
+ * @brief Numeric type representing values of the form (x + √D y) / z, with rational coefficients.
+ *
+ * @param D A square-free integer greater than one.
+ * @param Int The integral type of the coefficients.
+ */
+template <long long D, typename Int = long long>
+class quadratic_field {
+    static_assert(square_free(D), "D must be a square-free integer greater than one");
+
+  public:
+    //! @brief The integral type of the coefficients.
+    using integral_type = Int;
+
+    //! @brief √D approximated (constant-initialised, thus usable during static initialisation).
+    static constexpr double root = constexpr_sqrt(D);
+
+    //! @brief construction
+    //! @{
+    quadratic_field(Int na, Int nb, Int nd) : a(na), b(nb), d(nd) {
+        reduce();
+    }
+
+    quadratic_field(Int na, Int nb) : a(na), b(nb), d(1) {}
+
+    quadratic_field(Int na) : a(na), b(0), d(1) {}
+
+    quadratic_field() : a(0), b(0), d(1) {}
+    //! @}
+
+    //! @brief copy and assignment
+    //! @{
+    quadratic_field(const quadratic_field&) = default;
+
+    quadratic_field(quadratic_field&&) = default;
+
+    quadratic_field& operator=(const quadratic_field&) = default;
+
+    quadratic_field& operator=(quadratic_field&&) = default;
+    //! @}
+
+    //! @brief explicit conversion to double
+    explicit operator double() const {
+        return (double(a) + double(b) * root) / double(d);
+    }
+
+    //! @brief infix numeric operations
+    //! @{
+    quadratic_field operator+=(const quadratic_field& o) {
+        return *this = quadratic_field(a * o.d + o.a * d, b * o.d + o.b * d, d * o.d);
+    }
+
+    quadratic_field operator-=(const quadratic_field& o) {
+        return *this = quadratic_field(a * o.d - o.a * d, b * o.d - o.b * d, d * o.d);
+    }
+
+    quadratic_field operator*=(const quadratic_field& o) {
+        return *this = quadratic_field(a * o.a + D * b * o.b, b * o.a + a * o.b, d * o.d);
+    }
+
+    quadratic_field operator/=(const quadratic_field& o) {
+        Int q = o.a * o.a - D * o.b * o.b;
+        return *this = quadratic_field(o.d * (a * o.a - D * b * o.b), o.d * (b * o.a - a * o.b), d * q);
+    }
+    //! @}
+
+    //! @brief 3-way comparison
+    Int compare(const quadratic_field& o) const {
+        return sign(a * o.d - o.a * d, b * o.d - o.b * d);
+    }
+
+    //! @brief read-only access to coefficients
+    //! @{
+    Int integral() const {
+        return a;
+    }
+
+    Int irrational() const {
+        return b;
+    }
+
+    Int denominator() const {
+        return d;
+    }
+    //! @}
+
+    //! @brief a value with the sign of x + √D y
+    static Int sign(Int x, Int y) {
+        if (x >= 0 and y >= 0) return x + y;
+        if (x <= 0 and y <= 0) return x + y;
+        if (x > 0) return x * x - D * y * y;
+        return D * y * y - x * x;
+    }
+
+  private:
+    //! @brief reduces the coefficients to lowest terms with positive denominator
+    void reduce() {
+        if (d < 0) {
+            a = -a;
+            b = -b;
+            d = -d;
+        }
+        if (d == 1) return;
+        Int g = gcd(gcd(d, a < 0 ? -a : a), b < 0 ? -b : b);
+        a /= g;
+        b /= g;
+        d /= g;
+    }
+
+    //! @brief greatest common divisor of non-negative integers
+    static Int gcd(Int x, Int y) {
+        while (y > 0) {
+            x %= y;
+            if (x == 0) return y;
+            y %= x;
+        }
+        return x;
+    }
+
+    //! @brief Coefficients representing (a + √D b) / d.
+    Int a, b, d;
+};
+
+template <long long D, typename Int>
+constexpr double quadratic_field<D,Int>::root;
+
+
+//! @brief external comparison operators (to allow casting on first argument)
+//! @{
+template <long long D, typename Int>
+bool operator<(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    return x.compare(y) < 0;
+}
+
+template <long long D, typename Int>
+bool operator<=(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    return x.compare(y) <= 0;
+}
+
+template <long long D, typename Int>
+bool operator>(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    return x.compare(y) > 0;
+}
+
+template <long long D, typename Int>
+bool operator>=(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    return x.compare(y) >= 0;
+}
+
+template <long long D, typename Int>
+bool operator==(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    return x.compare(y) == 0;
+}
+
+template <long long D, typename Int>
+bool operator!=(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    return x.compare(y) != 0;
+}
+//! @}
+
+
+//! @brief mixed comparison operators with integral values (to allow casting on either argument)
+//! @{
+template <long long D, typename Int>
+bool operator<(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x).compare(y) < 0;
+}
+
+template <long long D, typename Int>
+bool operator<(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x.compare(quadratic_field<D,Int>(y)) < 0;
+}
+
+template <long long D, typename Int>
+bool operator<=(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x).compare(y) <= 0;
+}
+
+template <long long D, typename Int>
+bool operator<=(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x.compare(quadratic_field<D,Int>(y)) <= 0;
+}
+
+template <long long D, typename Int>
+bool operator>(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x).compare(y) > 0;
+}
+
+template <long long D, typename Int>
+bool operator>(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x.compare(quadratic_field<D,Int>(y)) > 0;
+}
+
+template <long long D, typename Int>
+bool operator>=(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x).compare(y) >= 0;
+}
+
+template <long long D, typename Int>
+bool operator>=(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x.compare(quadratic_field<D,Int>(y)) >= 0;
+}
+
+template <long long D, typename Int>
+bool operator==(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x).compare(y) == 0;
+}
+
+template <long long D, typename Int>
+bool operator==(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x.compare(quadratic_field<D,Int>(y)) == 0;
+}
+
+template <long long D, typename Int>
+bool operator!=(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x).compare(y) != 0;
+}
+
+template <long long D, typename Int>
+bool operator!=(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x.compare(quadratic_field<D,Int>(y)) != 0;
+}
+//! @}
+
+
+//! @brief external arithmetic operators (to allow casting on first argument)
+//! @{
+template <long long D, typename Int>
+quadratic_field<D,Int> operator+(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    if (x.denominator() == 1 and y.denominator() == 1)
+        return {x.integral() + y.integral(), x.irrational() + y.irrational()};
+    return {
+        x.integral() * y.denominator() + y.integral() * x.denominator(),
+        x.irrational() * y.denominator() + y.irrational() * x.denominator(),
+        x.denominator() * y.denominator()
+    };
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator-(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    if (x.denominator() == 1 and y.denominator() == 1)
+        return {x.integral() - y.integral(), x.irrational() - y.irrational()};
+    return {
+        x.integral() * y.denominator() - y.integral() * x.denominator(),
+        x.irrational() * y.denominator() - y.irrational() * x.denominator(),
+        x.denominator() * y.denominator()
+    };
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator*(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    if (x.denominator() == 1 and y.denominator() == 1) return {
+        x.integral() * y.integral() + D * x.irrational() * y.irrational(),
+        x.irrational() * y.integral() + x.integral() * y.irrational()
+    };
+    return {
+        x.integral() * y.integral() + D * x.irrational() * y.irrational(),
+        x.irrational() * y.integral() + x.integral() * y.irrational(),
+        x.denominator() * y.denominator()
+    };
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator/(const quadratic_field<D,Int>& x, const quadratic_field<D,Int>& y) {
+    Int q = y.integral() * y.integral() - D * y.irrational() * y.irrational();
+    return {
+        y.denominator() * (x.integral() * y.integral() - D * x.irrational() * y.irrational()),
+        y.denominator() * (x.irrational() * y.integral() - x.integral() * y.irrational()),
+        x.denominator() * q
+    };
+}
+//! @}
+
+
+//! @brief mixed arithmetic operators with integral values (to allow casting on either argument)
+//! @{
+template <long long D, typename Int>
+quadratic_field<D,Int> operator+(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x) + y;
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator-(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x) - y;
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator*(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x) * y;
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator/(typename quadratic_field<D,Int>::integral_type x, const quadratic_field<D,Int>& y) {
+    return quadratic_field<D,Int>(x) / y;
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator+(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x + quadratic_field<D,Int>(y);
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator-(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x - quadratic_field<D,Int>(y);
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator*(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x * quadratic_field<D,Int>(y);
+}
+
+template <long long D, typename Int>
+quadratic_field<D,Int> operator/(const quadratic_field<D,Int>& x, typename quadratic_field<D,Int>::integral_type y) {
+    return x / quadratic_field<D,Int>(y);
+}
+//! @}
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Scalar evaluation of a block of elements.
+    template <long long D, typename Int>
+    void evaluate(const quadratic_field<D,Int>* x, double* r, size_t n) {
+        for (size_t i = 0; i < n; ++i) r[i] = double(x[i]);
+    }
+
+    //! @brief Scalar comparison of a block of elements.
+    template <long long D, typename Int>
+    void compare(const quadratic_field<D,Int>* x, const quadratic_field<D,Int>* y, int* r, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            Int c = x[i].compare(y[i]);
+            r[i] = (c > 0) - (c < 0);
+        }
+    }
+
+#ifdef __AVX2__
+    //! @brief Bound on the magnitude of coefficients converted exactly by `to_double`.
+    constexpr long long avx_bound = 1LL << 51;
+
+    //! @brief Converts 64-bit integers within ±2^51 to doubles.
+    inline __m256d to_double(__m256i v) {
+        const __m256d magic = _mm256_set1_pd(6755399441055744.0); // 2^52 + 2^51
+        return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(v, _mm256_castpd_si256(magic))), magic);
+    }
+
+    //! @brief Lane mask of 64-bit integers within ±2^51.
+    inline __m256i in_range(__m256i v) {
+        return _mm256_and_si256(
+            _mm256_cmpgt_epi64(v, _mm256_set1_epi64x(-avx_bound-1)),
+            _mm256_cmpgt_epi64(_mm256_set1_epi64x(avx_bound+1), v)
+        );
+    }
+
+    //! @brief Gathers the coefficients of four consecutive elements (a, b, d).
+    inline void gather(const long long* p, __m256i& a, __m256i& b, __m256i& d) {
+        const __m256i idx = _mm256_setr_epi64x(0, 3, 6, 9);
+        a = _mm256_i64gather_epi64(p + 0, idx, 8);
+        b = _mm256_i64gather_epi64(p + 1, idx, 8);
+        d = _mm256_i64gather_epi64(p + 2, idx, 8);
+    }
+
+    //! @brief AVX2 evaluation of a block of elements.
+    template <long long D>
+    void evaluate(const quadratic_field<D,long long>* x, double* r, size_t n) {
+        static_assert(sizeof(quadratic_field<D,long long>) == 3*sizeof(long long), "unexpected padding");
+        const __m256d root = _mm256_set1_pd(quadratic_field<D,long long>::root);
+        const long long* p = reinterpret_cast<const long long*>(x);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4, p += 12) {
+            __m256i a, b, d;
+            gather(p, a, b, d);
+            __m256i ok = _mm256_and_si256(in_range(a), _mm256_and_si256(in_range(b), in_range(d)));
+            if (_mm256_movemask_pd(_mm256_castsi256_pd(ok)) != 15) {
+                for (size_t j = i; j < i+4; ++j) r[j] = double(x[j]);
+                continue;
+            }
+            __m256d v = _mm256_add_pd(to_double(a), _mm256_mul_pd(to_double(b), root));
+            _mm256_storeu_pd(r + i, _mm256_div_pd(v, to_double(d)));
+        }
+        for (; i < n; ++i) r[i] = double(x[i]);
+    }
+
+    //! @brief AVX2 comparison of a block of elements, falling back to exact comparison on close calls.
+    template <long long D>
+    void compare(const quadratic_field<D,long long>* x, const quadratic_field<D,long long>* y, int* r, size_t n) {
+        static_assert(sizeof(quadratic_field<D,long long>) == 3*sizeof(long long), "unexpected padding");
+        const __m256d root = _mm256_set1_pd(quadratic_field<D,long long>::root);
+        const __m256d sign = _mm256_set1_pd(-0.0);
+        // a few ulps for each of the two products, sums and divisions involved
+        const __m256d eps = _mm256_set1_pd(16 * 1.1102230246251565e-16);
+        const long long* p = reinterpret_cast<const long long*>(x);
+        const long long* q = reinterpret_cast<const long long*>(y);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4, p += 12, q += 12) {
+            __m256i xa, xb, xd, ya, yb, yd;
+            gather(p, xa, xb, xd);
+            gather(q, ya, yb, yd);
+            __m256i ok = _mm256_and_si256(
+                _mm256_and_si256(in_range(xa), _mm256_and_si256(in_range(xb), in_range(xd))),
+                _mm256_and_si256(in_range(ya), _mm256_and_si256(in_range(yb), in_range(yd)))
+            );
+            __m256d xr = _mm256_andnot_pd(sign, to_double(xa));
+            __m256d xi = _mm256_mul_pd(_mm256_andnot_pd(sign, to_double(xb)), root);
+            __m256d yr = _mm256_andnot_pd(sign, to_double(ya));
+            __m256d yi = _mm256_mul_pd(_mm256_andnot_pd(sign, to_double(yb)), root);
+            __m256d xv = _mm256_div_pd(_mm256_add_pd(to_double(xa), _mm256_mul_pd(to_double(xb), root)), to_double(xd));
+            __m256d yv = _mm256_div_pd(_mm256_add_pd(to_double(ya), _mm256_mul_pd(to_double(yb), root)), to_double(yd));
+            __m256d err = _mm256_mul_pd(eps, _mm256_add_pd(
+                _mm256_div_pd(_mm256_add_pd(xr, xi), to_double(xd)),
+                _mm256_div_pd(_mm256_add_pd(yr, yi), to_double(yd))
+            ));
+            __m256d diff = _mm256_sub_pd(xv, yv);
+            int gt = _mm256_movemask_pd(_mm256_cmp_pd(diff, err, _CMP_GT_OQ));
+            int lt = _mm256_movemask_pd(_mm256_cmp_pd(diff, _mm256_xor_pd(err, sign), _CMP_LT_OQ));
+            int valid = _mm256_movemask_pd(_mm256_castsi256_pd(ok));
+            for (int j = 0; j < 4; ++j) {
+                if ((valid >> j & 1) and (gt >> j & 1)) r[i+j] = 1;
+                else if ((valid >> j & 1) and (lt >> j & 1)) r[i+j] = -1;
+                else {
+                    long long c = x[i+j].compare(y[i+j]);
+                    r[i+j] = (c > 0) - (c < 0);
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            long long c = x[i].compare(y[i]);
+            r[i] = (c > 0) - (c < 0);
+        }
+    }
+#endif
+}
+//! @endcond
+
+
+//! @brief batch operations on arrays of elements (vectorised with AVX2 when available)
+//! @{
+//! @brief Writes `double(x[i])` into `r[i]` for every `i < n`.
+template <long long D, typename Int>
+void evaluate(const quadratic_field<D,Int>* x, double* r, size_t n) {
+    details::evaluate(x, r, n);
+}
+
+//! @brief Writes the sign (-1, 0 or 1) of `x[i] - y[i]` into `r[i]` for every `i < n`.
+template <long long D, typename Int>
+void compare(const quadratic_field<D,Int>* x, const quadratic_field<D,Int>* y, int* r, size_t n) {
+    details::compare(x, y, r, n);
+}
+//! @}
+
+
+//! @brief printing
+template <long long D, typename Int>
+std::ostream& operator<<(std::ostream& o, const quadratic_field<D,Int>& x) {
+    if (x.denominator() != 1) o << "(";
+    if (x.integral() != 0 or x.irrational() == 0) o << x.integral();
+    if (x.integral() != 0 and x.irrational() > 0) o << "+";
+    if (x.irrational() != 0) o << x.irrational() << "√" << D;
+    if (x.denominator() != 1) o << ")/" << x.denominator();
+    return o;
+}
+
+
+#endif // CPP_QUADRATIC_FIELD_H_
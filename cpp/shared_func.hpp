@@ -0,0 +1,194 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file shared_func.hpp
+ * @brief Implementation of the shared_func handle allowing lock-free concurrent access to a func.
+ */
+
+#ifndef CPP_SHARED_FUNC_H_
+#define CPP_SHARED_FUNC_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "func.hpp"
+
+
+/**
+ * @brief Read-mostly handle to a func shared among threads.
+ *
+ * Writers publish new versions by atomically swapping the current pointer. Readers access versions
+ * through a `reader`, which owns a hazard pointer announcing the version in use: retired versions
+ * are freed (by `publish` or `reclaim`) only when no hazard pointer refers to them, so that
+ * reclamation is safe at any time. Readers never lock and write only to their own hazard slot.
+ */
+class shared_func {
+    //! @brief A hazard slot.
+    struct slot;
+
+  public:
+    //! @brief maximum number of readers existing at the same time
+    static constexpr size_t max_readers = 64;
+
+    //! @brief Reader of a shared_func, to be used by a single thread at a time.
+    class reader {
+      public:
+        //! @brief claims a hazard slot of a shared_func
+        reader(shared_func& s) : m_slot(s.claim()) {}
+
+        //! @brief not copyable (owns a slot)
+        //! @{
+        reader(const reader&) = delete;
+
+        reader& operator=(const reader&) = delete;
+        //! @}
+
+        //! @brief releases the hazard slot
+        ~reader() {
+            m_slot.hazard.store(nullptr, std::memory_order_release);
+            m_slot.used.store(false, std::memory_order_release);
+        }
+
+        //! @brief protects the current version, valid until the next `acquire` or `release`
+        const func& acquire() {
+            const func* p = m_slot.owner->m_current.load(std::memory_order_acquire);
+            while (true) {
+                m_slot.hazard.store(p, std::memory_order_seq_cst);
+                const func* q = m_slot.owner->m_current.load(std::memory_order_seq_cst);
+                if (p == q) return *p;
+                p = q;
+            }
+        }
+
+        //! @brief stops protecting the acquired version
+        void release() {
+            m_slot.hazard.store(nullptr, std::memory_order_release);
+        }
+
+        //! @brief lock-free forwarding to the current version
+        //! @{
+        int dir(int x) {
+            int r = acquire().dir(x);
+            release();
+            return r;
+        }
+
+        int inv(int y) {
+            int r = acquire().inv(y);
+            release();
+            return r;
+        }
+
+        int convergence(int x) {
+            int r = acquire().convergence(x);
+            release();
+            return r;
+        }
+
+        int recovery(int x) {
+            int r = acquire().recovery(x);
+            release();
+            return r;
+        }
+
+        frac competitiveness() {
+            frac r = acquire().competitiveness();
+            release();
+            return r;
+        }
+        //! @}
+
+      private:
+        //! @brief the hazard slot owned
+        slot& m_slot;
+    };
+
+    //! @brief construction from an initial version
+    shared_func(func g) : m_versions(1) {
+        m_versions[0].reset(new func(std::move(g)));
+        m_current.store(m_versions[0].get(), std::memory_order_release);
+        for (slot& s : m_slots) s.owner = this;
+    }
+
+    //! @brief not copyable nor movable (readers refer to it)
+    //! @{
+    shared_func(const shared_func&) = delete;
+
+    shared_func& operator=(const shared_func&) = delete;
+    //! @}
+
+    //! @brief destruction (requires that no reader exists)
+    ~shared_func() {
+        for (slot& s : m_slots) assert(not s.used.load());
+    }
+
+    //! @brief publishes a new version, retiring the current one and freeing unused retired versions
+    void publish(func g) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_versions.emplace_back(new func(std::move(g)));
+        m_current.store(m_versions.back().get(), std::memory_order_seq_cst);
+        scan();
+    }
+
+    //! @brief frees the retired versions not protected by any reader
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        scan();
+    }
+
+    //! @brief number of versions not yet freed (including the current one)
+    size_t versions() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_versions.size();
+    }
+
+  private:
+    //! @brief A hazard slot (on its own cache line, so that readers do not interfere).
+    struct alignas(64) slot {
+        //! @brief whether the slot is owned by a reader
+        std::atomic<bool> used{false};
+        //! @brief the version protected by the reader
+        std::atomic<const func*> hazard{nullptr};
+        //! @brief the shared_func it belongs to
+        shared_func* owner;
+    };
+
+    //! @brief claims a free slot
+    slot& claim() {
+        for (slot& s : m_slots) {
+            bool f = false;
+            if (not s.used.load(std::memory_order_relaxed) and s.used.compare_exchange_strong(f, true, std::memory_order_acquire))
+                return s;
+        }
+        throw std::runtime_error("too many readers of a shared_func");
+    }
+
+    //! @brief frees retired versions not protected by hazard pointers (with the writer mutex held)
+    void scan() {
+        std::vector<const func*> hazards;
+        for (slot const& s : m_slots)
+            if (const func* p = s.hazard.load(std::memory_order_seq_cst)) hazards.push_back(p);
+        const func* current = m_current.load(std::memory_order_relaxed);
+        m_versions.erase(std::remove_if(m_versions.begin(), m_versions.end(), [&](std::unique_ptr<const func> const& v){
+            return v.get() != current and std::find(hazards.begin(), hazards.end(), v.get()) == hazards.end();
+        }), m_versions.end());
+    }
+
+    //! @brief the current version
+    std::atomic<const func*> m_current;
+    //! @brief the current and retired versions (modified only by writers)
+    std::vector<std::unique_ptr<const func>> m_versions;
+    //! @brief hazard slots of readers
+    std::array<slot, max_readers> m_slots;
+    //! @brief mutex serialising writers
+    mutable std::mutex m_mutex;
+};
+
+
+#endif // CPP_SHARED_FUNC_H_
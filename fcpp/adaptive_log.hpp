@@ -0,0 +1,126 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file adaptive_log.hpp
+ * @brief Implementation of the adaptive sequence, dense after events and sparse elsewhere.
+ */
+
+#ifndef FCPP_ADAPTIVE_LOG_H_
+#define FCPP_ADAPTIVE_LOG_H_
+
+#include <algorithm>
+#include <initializer_list>
+#include <ratio>
+#include <vector>
+
+#include "lib/common/tagged_tuple.hpp"
+#include "lib/settings.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing sequence generators.
+namespace sequence {
+
+
+/**
+ * @brief Sequence of times which are dense after events and sparse elsewhere.
+ *
+ * Times contain a uniform grid of period `P` starting from zero, so that consumers weighting times evenly
+ * can restrict to the grid. After every event (and time zero), further times follow a geometric progression
+ * starting with step `S` and growing by ratio `R`, while steps are shorter than `P`. The sequence ends with
+ * the end time.
+ *
+ * @param E Distribution of the end time.
+ * @param S The initial step after an event (as `std::ratio`).
+ * @param R The growth ratio of steps (as `std::ratio`).
+ * @param P The period of the grid (as `std::ratio`).
+ * @param Ds Distributions of the event times (generating a time, or an object whose `times()` are event times).
+ */
+template <typename E, typename S, typename R, typename P, typename... Ds>
+class adaptive {
+  public:
+    //! @brief The type of results generated.
+    using type = times_t;
+
+    //! @brief Default constructor.
+    template <typename G>
+    adaptive(G&& g) : adaptive(g, common::tagged_tuple_t<>{}) {}
+
+    //! @brief Tagged tuple constructor.
+    template <typename G, typename S_, typename T_>
+    adaptive(G&& g, const common::tagged_tuple<S_,T_>& t) {
+        times_t end = E{g, t}(g);
+        std::vector<times_t> events = {0};
+        (void)std::initializer_list<int>{(add_events(events, Ds{g, t}(g)), 0)...};
+        for (size_t k = 0; k * ratio<P>() < end; ++k)
+            m_times.push_back(k * ratio<P>());
+        for (times_t e : events) {
+            times_t step = ratio<S>();
+            for (times_t x = e; step < ratio<P>() and x < end; x += step, step *= ratio<R>())
+                m_times.push_back(x);
+        }
+        std::sort(m_times.begin(), m_times.end());
+        m_times.erase(std::unique(m_times.begin(), m_times.end()), m_times.end());
+        m_times.push_back(end);
+    }
+
+    //! @brief Check whether there is a next event.
+    bool empty() const {
+        return m_index >= m_times.size();
+    }
+
+    //! @brief Returns next event, without stepping over.
+    times_t next() const {
+        return empty() ? TIME_MAX : m_times[m_index];
+    }
+
+    //! @brief Steps over to next event, without returning.
+    template <typename G>
+    void step(G&&) {
+        ++m_index;
+    }
+
+    //! @brief Returns next event, stepping over.
+    template <typename G>
+    times_t operator()(G&& g) {
+        times_t t = next();
+        step(g);
+        return t;
+    }
+
+  private:
+    //! @brief Adds an event time.
+    static void add_events(std::vector<times_t>& events, times_t t) {
+        events.push_back(t);
+    }
+
+    //! @brief Adds the times of a list of events.
+    template <typename L>
+    static auto add_events(std::vector<times_t>& events, L const& l) -> decltype(void(l.times())) {
+        for (times_t t : l.times()) events.push_back(t);
+    }
+
+    //! @brief Converts a `std::ratio` to a time.
+    template <typename Q>
+    static constexpr times_t ratio() {
+        return times_t(Q::num) / Q::den;
+    }
+
+    //! @brief The times generated.
+    std::vector<times_t> m_times;
+    //! @brief The index of the next time.
+    size_t m_index = 0;
+};
+
+
+}
+
+
+}
+
+#endif // FCPP_ADAPTIVE_LOG_H_
@@ -8,10 +8,17 @@
 #ifndef FCPP_ELECTION_COMPARE_H_
 #define FCPP_ELECTION_COMPARE_H_
 
+#include <array>
+#include <initializer_list>
+#include <utility>
+
 #include "lib/beautify.hpp"
+#include "lib/coordination/basics.hpp"
 #include "lib/coordination/election.hpp"
 #include "lib/coordination/geometry.hpp"
 
+#include "fcpp/event_list.hpp"
+
 
 /**
  * @brief Namespace containing all the objects in the FCPP library.
@@ -27,9 +34,21 @@ namespace tags {
     //! @brief The size of the area where devices are located.
     struct area {};
 
-    //! @brief The time when node 0 should remove itself.
+    //! @brief The time of the first disruption.
     struct die_time {};
 
+    //! @brief The list of events of the scenario (including the first disruption).
+    struct scenario {};
+
+    //! @brief The total number of devices (including those arriving later).
+    struct dev_num {};
+
+    //! @brief The number of events occurred so far.
+    struct events {};
+
+    //! @brief The time elapsed since the last event occurred.
+    struct since {};
+
     //! @brief The movement speed of devices.
     struct speed {};
 
@@ -46,47 +65,107 @@ namespace tags {
     struct colr {};
     struct fwav {};
     struct fcol {};
+
+    template <typename T, int D>
+    struct stable {};
     //! @}
 }
 
 
-//! @brief Stabilise a value, accepting changes only after a number of rounds with the same value given by the delay.
-FUN(T) T stabiliser(ARGS, T value, int delay) { CODE
-    return get<0>(old(CALL, make_tuple(value,value,0), [&](tuple<T,T,int> o) {
-        if (value == get<1>(o)) ++get<2>(o);
-        else get<2>(o) = 1;
-        get<1>(o) = value;
-        if (get<2>(o) > delay) get<0>(o) = value;
+//! @brief The delay used by the stabilised algorithms `fwav` and `fcol`.
+constexpr int default_delay = 4;
+
+//! @brief Further delays evaluated for the stabilised algorithms (as `stable<wave, D>` and `stable<colr, D>`).
+using extra_delays = std::integer_sequence<int, 1, 2, 8, 16>;
+
+//! @brief Leaders elected by a stabilised algorithm, for the default delay followed by the extra delays.
+using stable_leaders = std::array<device_t, extra_delays::size()+1>;
+
+//! @brief The default delay followed by the extra delays.
+template <int... ds>
+constexpr std::array<int, sizeof...(ds)+1> delay_array(std::integer_sequence<int, ds...>) {
+    return {{default_delay, ds...}};
+}
+
+
+//! @brief Stabilise a value for several delays at once, accepting changes only after a number of rounds with the same value given by each delay.
+template <typename node_t, typename T, size_t N>
+std::array<T,N> multi_stabiliser(ARGS, T value, std::array<int,N> const& delays) { CODE
+    std::array<T,N> init;
+    init.fill(value);
+    return get<2>(old(CALL, make_tuple(value,0,init), [&](tuple<T,int,std::array<T,N>> o) {
+        if (value == get<0>(o)) ++get<1>(o);
+        else get<1>(o) = 1;
+        get<0>(o) = value;
+        for (size_t i=0; i<N; ++i)
+            if (get<1>(o) > delays[i]) get<2>(o)[i] = value;
         return o;
     }));
 }
 
+//! @brief Stores the leader elected by an algorithm, together with whether it is correct or spurious (never for absent devices).
+template <typename A, typename node_t>
+void store_election(node_t& node, device_t leader, device_t expected, bool present) {
+    node.storage(tags::leaders<A>{}) = leader;
+    node.storage(tags::correct<A>{}) = present and leader == expected;
+    node.storage(tags::spurious<A>{}) = present and leader > expected;
+}
+
+//! @brief Stores the leaders elected by an algorithm stabilised with the extra delays (skipping the default one).
+template <typename A, typename node_t, size_t N, int... ds>
+void store_delays(node_t& node, std::array<device_t,N> const& leaders, device_t expected, bool present, std::integer_sequence<int, ds...>) {
+    size_t i = 0;
+    (void)std::initializer_list<int>{(store_election<tags::stable<A,ds>>(node, leaders[++i], expected, present), 0)...};
+}
+
+//! @brief Leaders elected by the wave and colour algorithms, and by their stabilised versions.
+using elections_t = tuple<device_t, device_t, stable_leaders, stable_leaders>;
+
+//! @brief Computes the election algorithms compared.
+FUN() elections_t elections(ARGS) { CODE
+    device_t wave = wave_election(CALL);
+    device_t colr = color_election(CALL);
+    // all delays are evaluated from the same state, the default one first
+    stable_leaders fwav = multi_stabiliser(CALL, wave, delay_array(extra_delays{}));
+    stable_leaders fcol = multi_stabiliser(CALL, colr, delay_array(extra_delays{}));
+    return make_tuple(wave, colr, fwav, fcol);
+}
+
 //! @brief Computes several election algorithms for comparing them.
 FUN() void election_compare(ARGS) { CODE
     double L = node.storage(tags::area{});
     rectangle_walk(CALL, make_vec(0,0), make_vec(L,2), node.storage(tags::speed{}), 1);
-    bool perturbation = node.current_time() >= node.storage(tags::die_time{});
-    if (node.uid == 0 and perturbation) node.terminate();
-
-    device_t wave = wave_election(CALL);
-    device_t colr = color_election(CALL);
-    device_t fwav = stabiliser(CALL, wave, 4);
-    device_t fcol = stabiliser(CALL, colr, 4);
-
-    node.storage(tags::leaders<tags::wave>{}) = wave;
-    node.storage(tags::leaders<tags::colr>{}) = colr;
-    node.storage(tags::leaders<tags::fwav>{}) = fwav;
-    node.storage(tags::leaders<tags::fcol>{}) = fcol;
-
-    node.storage(tags::correct<tags::wave>{}) = wave == perturbation;
-    node.storage(tags::correct<tags::colr>{}) = colr == perturbation;
-    node.storage(tags::correct<tags::fwav>{}) = fwav == perturbation;
-    node.storage(tags::correct<tags::fcol>{}) = fcol == perturbation;
-
-    node.storage(tags::spurious<tags::wave>{}) = wave > perturbation;
-    node.storage(tags::spurious<tags::colr>{}) = colr > perturbation;
-    node.storage(tags::spurious<tags::fwav>{}) = fwav > perturbation;
-    node.storage(tags::spurious<tags::fcol>{}) = fcol > perturbation;
+    event_list const& s = node.storage(tags::scenario{});
+    size_t n = node.storage(tags::dev_num{});
+    times_t t = node.current_time();
+    if (s.removal(node.uid) <= t) node.terminate();
+    size_t k = s.occurred(t);
+    node.storage(tags::events{}) = k;
+    node.storage(tags::since{}) = t - s.time(k);
+    // during a partition, the upper half of identifiers forms a separate network: the split is by identifier
+    // rather than by region, so that the expected leader of each side follows from the scenario alone
+    // (as a region split would require the positions of every other device)
+    bool upper = s.partitioned(k) and node.uid >= n/2;
+    // the minimum identifier present in the same network
+    device_t expected = s.first_present(upper ? device_t(n/2) : s.leader(k), t, n);
+    bool present = s.present(node.uid, t, n);
+
+    stable_leaders none;
+    none.fill(expected);
+    elections_t e = make_tuple(expected, expected, none, none);
+    // devices yet to arrive take part in no election, and the two sides of a partition in separate ones
+    // (aligned by side, so that the upper half rejoins with a fresh state)
+    if (present) e = split(CALL, upper, [&](){
+        return elections(CALL);
+    });
+
+    store_election<tags::wave>(node, get<0>(e), expected, present);
+    store_election<tags::colr>(node, get<1>(e), expected, present);
+    store_election<tags::fwav>(node, get<2>(e)[0], expected, present);
+    store_election<tags::fcol>(node, get<3>(e)[0], expected, present);
+
+    store_delays<tags::wave>(node, get<2>(e), expected, present, extra_delays{});
+    store_delays<tags::colr>(node, get<3>(e), expected, present, extra_delays{});
 }
 
 
@@ -0,0 +1,195 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file event_list.hpp
+ * @brief Implementation of the event_list class describing the disruptions of a scenario.
+ */
+
+#ifndef FCPP_EVENT_LIST_H_
+#define FCPP_EVENT_LIST_H_
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "lib/settings.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief An event of a scenario.
+struct scenario_event {
+    //! @brief The kinds of events.
+    enum kind_t { removal, arrival, split, join };
+
+    //! @brief the time of the event
+    times_t time;
+    //! @brief the kind of event
+    kind_t kind;
+    //! @brief the device removed (for removals) or the number of devices arriving (for arrivals)
+    device_t value;
+};
+
+
+/**
+ * @brief List of events of a scenario, sorted by time.
+ *
+ * Lists are given compactly as a string of space-separated `time:event` pairs, where the event is:
+ * - an identifier, for the removal of that device;
+ * - `L`, for the removal of the leader at that time (the minimum identifier not yet removed);
+ * - `+N`, for the arrival of `N` devices (the highest identifiers, absent until then);
+ * - `split` and `join`, for the start and end of a partition between the lower and upper half of identifiers.
+ *
+ * For example, `"200:L 300:L 350:+100 400:split 450:join"` kills two successive leaders, then
+ * makes 100 devices arrive, then partitions the network for 50 time units. The schedule derived
+ * from a string is computed once and shared by all lists parsed from it, so that copies are cheap
+ * and queries need no allocation.
+ */
+class event_list {
+  public:
+    //! @brief empty list
+    event_list() : event_list(std::string()) {}
+
+    //! @brief parses a list from a string (sharing the schedule with previous lists from the same string)
+    event_list(std::string const& s) {
+        static std::mutex m;
+        static std::unordered_map<std::string, std::shared_ptr<const schedule>> cache;
+        std::lock_guard<std::mutex> lock(m);
+        std::shared_ptr<const schedule>& p = cache[s];
+        if (not p) p = std::make_shared<const schedule>(s);
+        m_schedule = p;
+    }
+
+    //! @brief number of events occurred up to a given time
+    size_t occurred(times_t t) const {
+        std::vector<times_t> const& v = m_schedule->times;
+        return std::upper_bound(v.begin(), v.end(), t) - v.begin();
+    }
+
+    //! @brief the time of the last of a number of events (zero for no events)
+    times_t time(size_t k) const {
+        return k == 0 ? 0 : m_schedule->times[k-1];
+    }
+
+    //! @brief the minimum identifier not removed after a number of events
+    device_t leader(size_t k) const {
+        return m_schedule->leaders[k];
+    }
+
+    //! @brief whether the network is partitioned after a number of events
+    bool partitioned(size_t k) const {
+        return m_schedule->partitioned[k];
+    }
+
+    //! @brief the time when a device is removed (`TIME_MAX` if never)
+    times_t removal(device_t uid) const {
+        auto it = m_schedule->removals.find(uid);
+        return it == m_schedule->removals.end() ? TIME_MAX : it->second;
+    }
+
+    //! @brief the time when a device arrives, out of a total number of devices (zero if present from start)
+    times_t arrival(device_t uid, size_t n) const {
+        std::vector<std::pair<times_t, size_t>> const& a = m_schedule->arrivals;
+        size_t first = n - std::min(n, a.empty() ? size_t(0) : a.back().second);
+        for (auto const& x : a)
+            if (uid < first + x.second) return uid < first ? 0 : x.first;
+        return 0;
+    }
+
+    //! @brief whether a device is present at a given time, out of a total number of devices
+    bool present(device_t uid, times_t t, size_t n) const {
+        return arrival(uid, n) <= t and removal(uid) > t;
+    }
+
+    //! @brief the minimum identifier from a given one which is present at a given time, out of a total number of devices
+    device_t first_present(device_t uid, times_t t, size_t n) const {
+        while (uid < n and not present(uid, t, n)) ++uid;
+        return uid;
+    }
+
+    //! @brief the times of the events in the list
+    std::vector<times_t> const& times() const {
+        return m_schedule->times;
+    }
+
+    //! @brief the events in the list
+    std::vector<scenario_event> const& events() const {
+        return m_schedule->events;
+    }
+
+  private:
+    //! @brief The schedule derived from a list of events.
+    struct schedule {
+        //! @brief Placeholder for the leader at the time of a removal.
+        static constexpr device_t leader_id = std::numeric_limits<device_t>::max();
+
+        //! @brief parses a list of events and derives the schedule
+        schedule(std::string const& s) {
+            std::istringstream in(s);
+            std::string e;
+            while (in >> e) {
+                size_t c = e.find(':');
+                if (c == std::string::npos or c+1 == e.size()) throw std::invalid_argument("scenario event without ':' in \"" + e + "\"");
+                times_t t = std::stod(e.substr(0, c));
+                std::string d = e.substr(c+1);
+                if (d == "split") events.push_back({t, scenario_event::split, 0});
+                else if (d == "join") events.push_back({t, scenario_event::join, 0});
+                else if (d == "L") events.push_back({t, scenario_event::removal, leader_id});
+                else if (d[0] == '+') events.push_back({t, scenario_event::arrival, device_t(std::stoull(d.substr(1)))});
+                else events.push_back({t, scenario_event::removal, device_t(std::stoull(d))});
+            }
+            std::stable_sort(events.begin(), events.end(), [](scenario_event const& x, scenario_event const& y){
+                return x.time < y.time;
+            });
+            device_t leader = 0;
+            bool split = false;
+            size_t arrived = 0;
+            leaders.push_back(leader);
+            partitioned.push_back(split);
+            for (scenario_event const& x : events) {
+                times.push_back(x.time);
+                if (x.kind == scenario_event::removal)
+                    removals.emplace(x.value == leader_id ? leader : x.value, x.time);
+                if (x.kind == scenario_event::arrival)
+                    arrivals.emplace_back(x.time, arrived += x.value);
+                if (x.kind == scenario_event::split) split = true;
+                if (x.kind == scenario_event::join) split = false;
+                while (removals.count(leader)) ++leader;
+                leaders.push_back(leader);
+                partitioned.push_back(split);
+            }
+        }
+
+        //! @brief The events sorted by time.
+        std::vector<scenario_event> events;
+        //! @brief The times of the events.
+        std::vector<times_t> times;
+        //! @brief The minimum identifier not removed after every number of events.
+        std::vector<device_t> leaders;
+        //! @brief Whether the network is partitioned after every number of events.
+        std::vector<bool> partitioned;
+        //! @brief The removal time of every removed device.
+        std::unordered_map<device_t, times_t> removals;
+        //! @brief The arrival times, with the total number of devices arrived by then.
+        std::vector<std::pair<times_t, size_t>> arrivals;
+    };
+
+    //! @brief The schedule shared by lists parsed from the same string.
+    std::shared_ptr<const schedule> m_schedule;
+};
+
+
+}
+
+#endif // FCPP_EVENT_LIST_H_
@@ -4,6 +4,7 @@ plot_builder="plotter/plot_builder.py"
 if ! [ -f $plot_builder ]; then
     plot_builder="extras/$plot_builder"
 fi
+profile_report=`dirname $plot_builder`/profile_report.py
 
 function usage() {
     echo -e "\033[4mcommands and parameters:\033[0m"
@@ -19,6 +20,8 @@ function usage() {
     echo -e "       <copts...> <targets...>"
     echo -e "    \033[1mrun\033[0m:                             build and runs a single target"
     echo -e "       <copts...> <target> <plots...> <arguments...>"
+    echo -e "    \033[1mprofile\033[0m:                         build and runs a single target, recording a report in output/profile"
+    echo -e "       <copts...> <target> <arguments...>"
     echo -e "    \033[1mall\033[0m:                             builds all possible targets and documentation"
     echo -e "       <copts...>"
     echo -e "Targets can be substrings demanding builds for all possible expansions. Syntax for plots is:"
@@ -101,6 +104,21 @@ function quitter() {
     exit $code
 }
 
+# runs a command recording wall time, peak RSS, CPU utilization, hardware counters and phase times as JSON
+function profiler() {
+    report="$1"
+    output="$2"
+    shift 2
+    counters="instructions,cycles,cache-references,cache-misses"
+    if perf stat -x, -e $counters true > /dev/null 2>&1; then
+        perf="1"
+    else
+        perf="0"
+    fi
+    python=`command -v python || command -v python3`
+    $python $profile_report "$report" "$output" "$perf" "$counters" "$@"
+}
+
 function mkdoc() {
     if [ ! -d doc ]; then
         mkdir doc
@@ -198,7 +216,7 @@ while [ "$1" != "" ]; do
         replace=""
         videoreplace=`echo -e "\033[7m&\033[0m"`
         shift 2
-        if [ "$1" != "" -a `echo $1 | grep "clean\|here\|gcc\|sed\|doc\|build\|test\|run\|all" | wc -l` -eq 0 ]; then
+        if [ "$1" != "" -a `echo $1 | grep "clean\|here\|gcc\|sed\|doc\|build\|test\|run\|profile\|all" | wc -l` -eq 0 ]; then
             replace="$1"
             videoreplace=`echo -e "\033[31m[-&-]\033[32m{+$replace+}\033[0m"`
             shift 1
@@ -314,7 +332,7 @@ while [ "$1" != "" ]; do
             if [ ${#exitcodes[@]} -gt 0 ]; then
                 quitter
             fi
-            mkdir -p output/raw
+            mkdir -p output/raw output/profile
             $built "$@" > $file & pid=$!
             trap ctrl_c INT
             function ctrl_c() {
@@ -362,6 +380,31 @@ while [ "$1" != "" ]; do
             fi
         fi
         quitter
+    elif [ "$1" == "profile" ]; then
+        shift 1
+        parseopt "$@"
+        shift $?
+        finder "$1" "cc_binary"
+        if [ "$targets" == "" ]; then
+            echo -e "\033[1mtarget \"$1\" not found\033[0m"
+        elif [ `echo $targets | tr ' ' '\n' | wc -l` -ne 1 ]; then
+            echo -e "\033[1mtarget is not unique\033[0m"
+            echo $targets | tr ' ' '\n' | sed 's|^|//|'
+        else
+            shift 1
+            name=`echo $targets | sed 's|.*:||'`
+            built=`echo bazel-bin/$targets | tr ':' '/'`
+            builder build $targets
+            if [ ${#exitcodes[@]} -gt 0 ]; then
+                quitter
+            fi
+            mkdir -p output/raw output/profile
+            report="output/profile/$name-`date +%Y%m%d-%H%M%S`.json"
+            echo -e "\033[4mPROFILING: $built $@\033[0m"
+            reporter profiler $report output/raw/$name.txt $built "$@"
+            cat $report
+        fi
+        quitter
     elif [ "$1" == "all" ]; then
         shift 1
         parseopt "$@"
@@ -99,10 +99,35 @@ def rounder(f):
     f = round(float(f),2)
     return repr(int(f) if f == int(f) else f)
 
+# parses a parameter value, as None if not numeric (e.g. a scenario of events)
+def parameter(v):
+    if v in ["false", "true"]:
+        return float(v == "true")
+    try:
+        return float(v)
+    except ValueError:
+        return None
+
 # checks if floats are reasonably different
 def farenough(x, y):
     return abs(x-y) > max(1e-4, (x+y)/2e2)
 
+# linearly interpolates rows with uneven times (first column) onto unit time steps
+def resample(rows):
+    if len(rows) < 2 or all(abs(rows[i+1][0] - rows[i][0] - 1) < 1e-9 for i in xrange(len(rows)-1)):
+        return rows
+    res = []
+    i = 0
+    t = math.ceil(rows[0][0])
+    while t <= rows[-1][0]:
+        while rows[i+1][0] < t:
+            i += 1
+        a, b = rows[i], rows[i+1]
+        f = 0.0 if b[0] == a[0] else (t - a[0]) / (b[0] - a[0])
+        res.append([t] + [x*(1-f) + y*f for x, y in zip(a[1:], b[1:])])
+        t += 1
+    return res
+
 # computes the ordered cartesian product of the given lists
 def cartesian(l):
     if len(l) == 0:
@@ -142,7 +167,8 @@ class DB:
             vars = rows[3][1:].strip()
             vars = vars.split(', ') if len(vars) else []
             vars = [v.split(' = ') for v in vars]
-            vars, vals = [v[0] for v in vars], [0.0 if v[1]=="false" else 1.0 if v[1]=="true" else float(v[1]) for v in vars]
+            vars = [(v[0], parameter(v[1])) for v in vars]
+            vars, vals = [v[0] for v in vars if v[1] is not None], [v[1] for v in vars if v[1] is not None]
             hdr = rows[6][1:].strip().split(' ')
             kind = [int(h[-11:] == "@every_node") for h in hdr]
             hdr = map(prettify, vars + hdr)
@@ -163,10 +189,14 @@ class DB:
                     print >> sys.stderr, hdr
                     print >> sys.stderr, self.hdr
                     exit(1)
+            lines = []
             for r in rows[8:]:
                 if r[0] == '#':
-                    return
-                data = map(float, r.strip().split(' '))
+                    break
+                lines.append(map(float, r.strip().split(' ')))
+            if rows[6][1:].strip().split(' ')[0] == 'time':
+                lines = resample(lines)
+            for data in lines:
                 for d in xrange(devnum):
                     t = vals + [data[index[i]+d*kind[i]] for i in xrange(ctot)]
                     if cdev:
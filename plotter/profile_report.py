@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+
+import sys, os, json, time, resource, subprocess
+
+
+# runs a command (under perf stat if available) with its output redirected, returning exit code and wall time
+def execute(cmd, output, report, perf, counters):
+    env = dict(os.environ, PHASE_TIMES=report+".phases")
+    run = ["perf", "stat", "-x,", "-o", report+".perf", "-e", counters] + cmd if perf else cmd
+    start = time.time()
+    with open(output, "w") as f:
+        code = subprocess.call(run, stdout=f, env=env)
+    return code, time.time() - start
+
+# reads the hardware counters written by perf stat
+def read_counters(file, counters):
+    data = {}
+    for line in open(file):
+        f = line.strip().split(",")
+        if len(f) > 2 and f[2] in counters.split(","):
+            data[f[2]] = int(f[0]) if f[0].isdigit() else None
+    return data
+
+# reads the "name seconds" lines written by the phase timer of the program
+def read_phases(file):
+    data = {}
+    for line in open(file):
+        name, secs = line.split()
+        data[name] = float(secs)
+    return data
+
+
+if len(sys.argv) < 6:
+    print("usage: %s <report> <output> <perf> <counters> <command...>" % sys.argv[0])
+    sys.exit(1)
+
+report, output, perf, counters, cmd = sys.argv[1], sys.argv[2], sys.argv[3] == "1", sys.argv[4], sys.argv[5:]
+code, wall = execute(cmd, output, report, perf, counters)
+usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+cpu = usage.ru_utime + usage.ru_stime
+data = {
+    "command":          " ".join(cmd),
+    "exit_code":        code,
+    "wall_time_s":      wall,
+    "cpu_time_s":       cpu,
+    "cpu_utilization":  cpu / wall if wall > 0 else 0,
+    "peak_rss_mb":      usage.ru_maxrss / (1048576.0 if sys.platform == "darwin" else 1024.0),
+    "counters":         None,
+    "phases_s":         {},
+}
+if perf:
+    data["counters"] = read_counters(report+".perf", counters)
+    os.remove(report+".perf")
+if os.path.isfile(report+".phases"):
+    data["phases_s"] = read_phases(report+".phases")
+    os.remove(report+".phases")
+with open(report, "w") as f:
+    json.dump(data, f, indent=4, sort_keys=True)
+    f.write("\n")
+sys.exit(code)
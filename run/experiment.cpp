@@ -1,7 +1,20 @@
 // Copyright © 2020 Giorgio Audrito. All Rights Reserved.
 
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "lib/fcpp.hpp"
 
+#include "cpp/latin_hypercube.hpp"
+#include "cpp/phase_timer.hpp"
+#include "cpp/progress.hpp"
+#include "fcpp/adaptive_log.hpp"
 #include "fcpp/election_compare.hpp"
 
 using namespace fcpp;
@@ -17,9 +30,10 @@ struct dens {};      // average density                     = 10, 20, 30
 //     speed         // maximum movement speed              = 0, 0.25, 0.5
 
 struct round_dev {}; // standard deviation in round length  = sync ? 0 : 0.25
-struct dev_num {};   // total number of devices             = dens*area*2/π
+//     dev_num       // total number of devices             = dens*area*2/π
 struct end_time {};  // time for end simulation             = 10*area
 //     die_time      // time for disruption                 = 5*area
+//     scenario      // events (as "time:event" pairs)      = die_time:0, followed by further events
 
                      // total complexity of simulation      = (2*dens*area)^2
 
@@ -40,11 +54,18 @@ using round_s = sequence::periodic<
     distribution::constant_i<times_t, end_time>
 >;
 
-using export_s = sequence::periodic<d0, d1, distribution::constant_i<times_t, end_time>>;
+// logs every 5 time units, and also with steps growing from 1/2 by 6/5 after start and every scenario event
+// (about one per time unit in the 10 time units following an event, where the transients happen)
+using export_s = sequence::adaptive<
+    distribution::constant_i<times_t, end_time>,
+    std::ratio<1,2>, std::ratio<6,5>, std::ratio<5>,
+    distribution::constant_i<event_list, scenario>
+>;
 
 using rectangle_d = distribution::rect<d0, d0, distribution::constant_i<double, area>, d2>;
 
-using aggregator_t = aggregators<
+// the algorithms compared in the main plots
+using main_aggregators_t = aggregators<
         leaders<wave>,      aggregator::distinct<device_t>,
         leaders<colr>,      aggregator::distinct<device_t>,
         leaders<fwav>,      aggregator::distinct<device_t>,
@@ -61,25 +82,121 @@ using aggregator_t = aggregators<
         spurious<fcol>,     aggregator::sum<int>
     >;
 
-struct custom_filter {
+// the stabilised algorithms with the extra delays, plotted on their own page
+using delay_aggregators_t = aggregators<
+        leaders<stable<wave,1>>,      aggregator::distinct<device_t>,
+        leaders<stable<wave,2>>,      aggregator::distinct<device_t>,
+        leaders<stable<wave,8>>,      aggregator::distinct<device_t>,
+        leaders<stable<wave,16>>,     aggregator::distinct<device_t>,
+        leaders<stable<colr,1>>,      aggregator::distinct<device_t>,
+        leaders<stable<colr,2>>,      aggregator::distinct<device_t>,
+        leaders<stable<colr,8>>,      aggregator::distinct<device_t>,
+        leaders<stable<colr,16>>,     aggregator::distinct<device_t>,
+
+        correct<stable<wave,1>>,      aggregator::sum<int>,
+        correct<stable<wave,2>>,      aggregator::sum<int>,
+        correct<stable<wave,8>>,      aggregator::sum<int>,
+        correct<stable<wave,16>>,     aggregator::sum<int>,
+        correct<stable<colr,1>>,      aggregator::sum<int>,
+        correct<stable<colr,2>>,      aggregator::sum<int>,
+        correct<stable<colr,8>>,      aggregator::sum<int>,
+        correct<stable<colr,16>>,     aggregator::sum<int>,
+
+        spurious<stable<wave,1>>,     aggregator::sum<int>,
+        spurious<stable<wave,2>>,     aggregator::sum<int>,
+        spurious<stable<wave,8>>,     aggregator::sum<int>,
+        spurious<stable<wave,16>>,    aggregator::sum<int>,
+        spurious<stable<colr,1>>,     aggregator::sum<int>,
+        spurious<stable<colr,2>>,     aggregator::sum<int>,
+        spurious<stable<colr,8>>,     aggregator::sum<int>,
+        spurious<stable<colr,16>>,    aggregator::sum<int>
+    >;
+
+// concatenation of lists of aggregators
+template <typename... Ts>
+struct join_aggregators;
+template <typename... As>
+struct join_aggregators<aggregators<As...>> {
+    using type = aggregators<As...>;
+};
+template <typename... As, typename... Bs, typename... Ts>
+struct join_aggregators<aggregators<As...>, aggregators<Bs...>, Ts...> : join_aggregators<aggregators<As..., Bs...>, Ts...> {};
+
+using aggregator_t = typename join_aggregators<
+    main_aggregators_t,
+    delay_aggregators_t,
+    aggregators<
+        events,             aggregator::max<int>,
+        since,              aggregator::max<times_t>
+    >
+>::type;
+
+// rows on the uniform grid of export_s, so that pages aggregating over time weight it evenly
+struct grid_filter {
+    template <typename V>
+    bool operator()(V v) const {
+        return std::fmod(v, 5) == 0;
+    }
+};
+
+// rows at least 50 time units after the start or the disruption, away from the transients
+struct settled_filter {
     template <typename V>
     bool operator()(V v) const {
-        if (50 <= v and v <= 100) return true;
-        if (150 <= v and v <= 200) return true;
-        return false;
+        return v >= 50;
     }
 };
 
-template <typename xvar, template<class> class yvar, typename bucket, typename aggr>
-using plot_t = plot::split<xvar, plot::values<aggregator_t, common::type_sequence<aggr>, plot::unit<yvar>>, bucket>;
-template <typename xvar, typename bucket, typename aggr>
-using plot_row_t = plot::join<plot_t<xvar, leaders, bucket, aggr>, plot_t<xvar, correct, bucket, aggr>, plot_t<xvar, spurious, bucket, aggr>>;
-template <typename xvar, typename fvar, typename bucket = std::ratio<0>, typename aggr = aggregator::mean<double>>
-using plot_page_t = plot::filter<fvar, filter::equal<0>, plot::split<sync, plot_row_t<xvar, bucket, aggr>>>;
-using plotter_t = plot::join<plot_page_t<plot::time, speed>, plot::filter<plot::time, filter::above<100>, plot_page_t<speed, sync>>, plot::filter<plot::time, filter::below<100>, plot_page_t<speed, sync>>, plot::filter<plot::time, custom_filter, plot_page_t<speed, sync>>>;
+template <typename xvar, template<class> class yvar, typename bucket, typename aggr, typename A>
+using plot_t = plot::split<xvar, plot::values<A, common::type_sequence<aggr>, plot::unit<yvar>>, bucket>;
+template <typename xvar, typename bucket, typename aggr, typename A = main_aggregators_t>
+using plot_row_t = plot::join<plot_t<xvar, leaders, bucket, aggr, A>, plot_t<xvar, correct, bucket, aggr, A>, plot_t<xvar, spurious, bucket, aggr, A>>;
+template <typename xvar, typename fvar, typename bucket = std::ratio<0>, typename aggr = aggregator::mean<double>, typename A = main_aggregators_t>
+using plot_page_t = plot::filter<fvar, filter::equal<0>, plot::split<sync, plot_row_t<xvar, bucket, aggr, A>>>;
+// a page restricted to times after, before and away from the disruption (on the uniform grid), told apart
+// through the logged number of events and time since the last, as the disruption time varies with the area
+template <typename page_t>
+using time_pages_t = plot::filter<plot::time, grid_filter, plot::join<plot::filter<aggregator::max<events>, filter::equal<1>, page_t>, plot::filter<aggregator::max<events>, filter::equal<0>, page_t>, plot::filter<aggregator::max<since>, settled_filter, page_t>>>;
+// pages against time use every row, dense after start and the disruption
+using plotter_t = plot::join<plot_page_t<plot::time, speed>, time_pages_t<plot_page_t<speed, sync>>, plot_page_t<plot::time, speed, std::ratio<0>, aggregator::mean<double>, delay_aggregators_t>>;
+// recovery after every event of a scripted scenario, against the time elapsed since it (on all rows, which are dense after events)
+using event_plotter_t = plot::split<aggregator::max<events>, plot_row_t<aggregator::max<since>, std::ratio<0>, aggregator::mean<double>>>;
+// scattered samples are binned along every sampled parameter
+using sample_plotter_t = plot::join<time_pages_t<plot_page_t<speed, sync, std::ratio<1,10>>>, time_pages_t<plot_page_t<dens, sync, std::ratio<5>>>, time_pages_t<plot_page_t<area, sync, std::ratio<5>>>, time_pages_t<plot_page_t<round_dev, sync, std::ratio<1,20>>>>;
 
 
-template <bool is_sync>
+// plotter serialising the insertion of rows with the building of plots (which may happen while simulations proceed),
+// and timing the insertion (where rows are aggregated into the plots)
+template <typename P>
+class locked_plotter : public P {
+  public:
+    template <typename R>
+    locked_plotter& operator<<(R const& row) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto start = std::chrono::steady_clock::now();
+        P::operator<<(row);
+        m_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return *this;
+    }
+
+    auto build() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return P::build();
+    }
+
+    // seconds spent inserting rows so far
+    double time() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_time;
+    }
+
+  private:
+    std::mutex m_mutex;
+    double m_time = 0;
+};
+
+
+template <bool is_sync, typename plot_type_t = locked_plotter<plotter_t>>
 DECLARE_OPTIONS(opt,
     synchronised<is_sync>,
     parallel<false>,
@@ -89,13 +206,15 @@ DECLARE_OPTIONS(opt,
     exports<
         tuple<device_t, device_t, int>, vec<2>,
         tuple<device_t, int>, tuple<device_t, int, int, int>,
-        tuple<bool,device_t,int,device_t>, tuple<bool,device_t,int,device_t,bool>
+        tuple<bool,device_t,int,device_t>, tuple<bool,device_t,int,device_t,bool>,
+        tuple<device_t, int, stable_leaders>
     >,
     log_schedule<export_s>,
     aggregator_t,
     tuple_store<
         area,               double,
-        die_time,           times_t,
+        scenario,           event_list,
+        dev_num,            size_t,
         speed,              double,
 
         leaders<wave>,      device_t,
@@ -111,46 +230,168 @@ DECLARE_OPTIONS(opt,
         spurious<wave>,     int,
         spurious<colr>,     int,
         spurious<fwav>,     int,
-        spurious<fcol>,     int
+        spurious<fcol>,     int,
+
+        leaders<stable<wave,1>>,      device_t,
+        leaders<stable<wave,2>>,      device_t,
+        leaders<stable<wave,8>>,      device_t,
+        leaders<stable<wave,16>>,     device_t,
+        leaders<stable<colr,1>>,      device_t,
+        leaders<stable<colr,2>>,      device_t,
+        leaders<stable<colr,8>>,      device_t,
+        leaders<stable<colr,16>>,     device_t,
+
+        correct<stable<wave,1>>,      int,
+        correct<stable<wave,2>>,      int,
+        correct<stable<wave,8>>,      int,
+        correct<stable<wave,16>>,     int,
+        correct<stable<colr,1>>,      int,
+        correct<stable<colr,2>>,      int,
+        correct<stable<colr,8>>,      int,
+        correct<stable<colr,16>>,     int,
+
+        spurious<stable<wave,1>>,     int,
+        spurious<stable<wave,2>>,     int,
+        spurious<stable<wave,8>>,     int,
+        spurious<stable<wave,16>>,    int,
+        spurious<stable<colr,1>>,     int,
+        spurious<stable<colr,2>>,     int,
+        spurious<stable<colr,8>>,     int,
+        spurious<stable<colr,16>>,    int,
+
+        events,             int,
+        since,              times_t
     >,
-    extra_info<sync, int, speed, double>,
-    plot_type<plotter_t>,
+    extra_info<sync, int, speed, double, dens, double, area, double, round_dev, double>,
+    plot_type<plot_type_t>,
     spawn_schedule<spawn_s<is_sync>>,
     init<
         x,          rectangle_d,
         area,       distribution::constant_i<double, area>,
         speed,      distribution::constant_i<double, speed>,
         round_dev,  distribution::constant_i<double, round_dev>,
-        die_time,   distribution::constant_i<times_t, die_time>,
+        scenario,   distribution::constant_i<event_list, scenario>,
+        dev_num,    distribution::constant_i<size_t, dev_num>,
         end_time,   distribution::constant_i<times_t, end_time>
     >,
     connector<connect::fixed<>>
 );
 
-plotter_t P;
+locked_plotter<plotter_t> P;
+locked_plotter<sample_plotter_t> Q;
+locked_plotter<event_plotter_t> E;
+// time spent in simulation, final plot building and aggregation of rows into the plots (which is part of the simulation,
+// interleaved with it; the collection of the aggregators of devices into rows happens within fcpp, and is not timed apart)
+phase_timer phases;
 
-auto make_parameters(bool is_sync, int runs, std::string var = "none") {
+// further events (e.g. "300:L 350:+100 400:split 450:join") are appended to the disruption, and plotted separately
+// (their raw files are named apart, as the plot builder run by ./make.sh reads every output/raw/experiment*.txt)
+template <typename R = locked_plotter<plotter_t>>
+auto make_parameters(bool is_sync, int runs, std::string var = "none", std::string further = "", R* plots = &P) {
     return batch::make_tagged_tuple_sequence(
         batch::arithmetic<seed>(0, runs-1, 1),
         batch::constant<sync>(is_sync),
         batch::arithmetic<speed>(0.025 * (var == "speed"), 1.001 * (var == "speed"), 0.025),
         batch::arithmetic<dens>(10 + 10 * (var != "dens"), 40, 30),
         batch::arithmetic<area>(10 + 10 * (var != "area"), 40, 30),
-        batch::stringify<output>("output/raw/experiment", "txt"),
-        batch::constant<plotter>(&P),
+        batch::stringify<output>(further.empty() ? "output/raw/experiment" : "output/raw/election-events", "txt"),
+        batch::constant<plotter>(plots),
         batch::formula<round_dev>([&](auto const& t){ return is_sync ? 0 : 0.25; }),
         batch::formula<dev_num  >([ ](auto const& t){ return (common::get<dens>(t)*common::get<area>(t)*200)/314; }),
         batch::formula<end_time >([ ](auto const& t){ return common::get<area>(t)*10; }),
-        batch::formula<die_time >([ ](auto const& t){ return common::get<area>(t)*5; })
+        batch::formula<die_time >([ ](auto const& t){ return common::get<area>(t)*5; }),
+        batch::formula<scenario >([further](auto const& t){ return std::to_string(common::get<die_time>(t)) + ":0" + (further.empty() ? "" : " " + further); })
     );
 }
 
-int main() {
-    batch::run(component::batch_simulator<opt<true>>{},
-               make_parameters(true, runs*5));
-    batch::run(component::batch_simulator<opt<false>>{},
-               make_parameters(false, runs*5),
-               make_parameters(false, runs, "speed"));
+// asynchronous parameters drawn from a Latin hypercube over speed, dens, area and round_dev, as an alternative to the full factorial
+using sample_t = common::tagged_tuple_t<
+    seed, int, sync, bool, speed, double, dens, double, area, double, round_dev, double,
+    output, std::string, plotter, locked_plotter<sample_plotter_t>*,
+    dev_num, size_t, end_time, times_t, die_time, times_t, scenario, std::string
+>;
+auto make_samples(int budget) {
+    if (budget <= 0) throw std::invalid_argument("sample budget must be positive (got " + std::to_string(budget) + ")");
+    std::vector<sample_t> v(budget);
+    auto points = latin_hypercube<4>(budget);
+    for (int i = 0; i < budget; ++i) {
+        sample_t& t = v[i];
+        common::get<seed     >(t) = i;
+        common::get<sync     >(t) = false;
+        common::get<speed    >(t) = points[i][0];
+        common::get<dens     >(t) = 10 + 30 * points[i][1];
+        common::get<area     >(t) = 10 + 30 * points[i][2];
+        common::get<round_dev>(t) = 0.5 * points[i][3];
+        common::get<output   >(t) = "output/raw/election-sample_seed-" + std::to_string(i) + ".txt";
+        common::get<plotter  >(t) = &Q;
+        common::get<dev_num  >(t) = common::get<dens>(t) * common::get<area>(t) * 200 / 314;
+        common::get<end_time >(t) = common::get<area>(t) * 10;
+        common::get<die_time >(t) = common::get<area>(t) * 5;
+        common::get<scenario >(t) = std::to_string(common::get<die_time>(t)) + ":0";
+    }
+    return v;
+}
+
+// reporter of the progress of the current sweep
+progress* reporter = nullptr;
+
+// simulator whose networks notify the progress reporter when their run ends
+template <typename T>
+struct reported_simulator {
+    struct net : T::net {
+        using T::net::net;
+
+        void run() {
+            T::net::run();
+            reporter->done();
+        }
+    };
+};
+
+// writes the plots built so far (from the progress reporter thread, while the simulations proceed, locking out row insertion)
+template <typename R>
+std::function<void()> partial_plot(R& plots) {
+    return [&plots](){
+        std::ofstream f("output/experiment-partial.asy");
+        f << plot::file("experiment-partial", plots.build());
+    };
+}
+
+// with arguments "sample <budget>", runs a Latin hypercube sample of the given size instead of the full factorial
+int main(int argc, char** argv) {
+    if (argc > 2 and std::string(argv[1]) == "sample") {
+        auto sample_s = make_samples(std::stoi(argv[2]));
+        {
+            std::ofstream log("output/experiment-progress.txt");
+            progress prog(sample_s.size(), 60, partial_plot(Q), log);
+            reporter = &prog;
+            phases.start("simulation");
+            batch::run(reported_simulator<component::batch_simulator<opt<false, locked_plotter<sample_plotter_t>>>>{}, sample_s);
+        }
+        phases.add("aggregation", Q.time());
+        phases.start("plot");
+        std::cout << plot::file("experiment", Q.build());
+        return 0;
+    }
+    auto sync_s = make_parameters(true, runs*5);
+    auto async_s = make_parameters(false, runs*5);
+    auto speed_s = make_parameters(false, runs, "speed");
+    // with area 20, the leader is killed at 100, then again at 120, devices arrive at 140, and the network is split from 160 to 180
+    auto event_s = make_parameters(false, runs, "none", "120:L 140:+60 160:split 180:join", &E);
+    {
+        // progress lines go to a file, as the terminal is redrawn by the monitor of ./make.sh run
+        std::ofstream log("output/experiment-progress.txt");
+        progress prog(sync_s.size() + async_s.size() + speed_s.size() + event_s.size(), 60, partial_plot(P), log);
+        reporter = &prog;
+        phases.start("simulation");
+        batch::run(reported_simulator<component::batch_simulator<opt<true>>>{}, sync_s);
+        batch::run(reported_simulator<component::batch_simulator<opt<false>>>{}, async_s, speed_s);
+        batch::run(reported_simulator<component::batch_simulator<opt<false, locked_plotter<event_plotter_t>>>>{}, event_s);
+    }
+    phases.add("aggregation", P.time() + E.time());
+    phases.start("plot");
     std::cout << plot::file("experiment", P.build());
+    std::ofstream f("output/election-events.asy");
+    f << plot::file("election-events", E.build());
     return 0;
 }
@@ -1,9 +1,22 @@
+#include <algorithm>
+#include <cassert>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 
+#include "cpp/arena.hpp"
 #include "cpp/func.hpp"
+#include "cpp/phase_timer.hpp"
 
-// double checks that the constraints are satisfied
+// function type allocating from a reusable arena (recycling the buffers freed while growing)
+using arena_func = basic_func<arena_allocator<int, pool_arena>>;
+
+#ifdef FUNC_PROFILING
+// trace of generation statistics for every candidate
+std::ofstream trace("output/profile/parameter-profile.txt");
+#endif
+
+// double checks that the constraints are satisfied (exact reference sweep)
 frac double_check(const func& g, int L) {
     frac K = 1;
     for (int x=0; x<L; ++x)
@@ -11,18 +24,46 @@ frac double_check(const func& g, int L) {
     return K;
 }
 
+// double checks that the constraints are satisfied, sweeping blocks in floating point first
+// (only ratios reaching the running maximum in floating point are compared exactly: since
+// integers are converted exactly and divisions rounded correctly, rounding is monotonic
+// and no ratio that is exactly larger can appear smaller, so the result is the same as above)
+frac fast_check(const func& g, int L) {
+    constexpr int B = 1024;
+    int rs[B];
+    double qs[B];
+    frac K = 1;
+    double k = 1;
+    for (int x0=0; x0<L; x0+=B) {
+        int n = std::min(B, L-x0);
+        for (int i=0; i<n; ++i)
+            rs[i] = g.recovery(x0+i);
+        for (int i=0; i<n; ++i)
+            qs[i] = double(rs[i]) / double(2*(x0+i) + 1);
+        if (*std::max_element(qs, qs+n) < k) continue;
+        for (int i=0; i<n; ++i) if (qs[i] >= k) {
+            K = std::max(K, frac(rs[i], g.ideal(x0+i)));
+            k = double(K);
+        }
+    }
+    return K;
+}
+
 // searches for the best competitiveness within [a,b]
 std::pair<frac,frac> best_competitiveness(frac a, frac b) {
     // invariant: func(a) fails, func(b) succeeds with competitiveness k
-    frac k = func(b).competitiveness();
+    pool_arena arena;
+    frac k = arena_func(b, arena).competitiveness();
     while (k > a) { // when k == a, k is minimum and b upper bound
         frac c = double(b-a) > 1e-7 ? (a+b)/2 : k;
         if (c > k) {
             b = c;
             continue;
         }
-        func g(c);
+        arena.reset(); // memory from the previous candidate is reused
+        arena_func g(c, arena);
         frac r = g.competitiveness();
+        FUNC_PROFILE(trace << c << "\t" << double(c) << "\t" << g.profile() << std::endl;)
         if (r < c) {
             std::cout << "success for " << c << " with " << r << " = " << double(r) << " at x = " << g.size() << std::endl;
             b = c;
@@ -37,30 +78,44 @@ std::pair<frac,frac> best_competitiveness(frac a, frac b) {
 
 
 int main() {
+    // time spent searching for functions and checking them
+    phase_timer phases;
     int L = 10000000;
     std::cout.precision(17);
     {
         std::cout << "SEARCHING BEST COMPETITIVENESS" << std::endl;
+        phases.start("search");
         auto p = best_competitiveness(frac(29,12), frac(25,10));
+        phases.stop();
         frac K = p.first;  // 32/13
         frac U = p.second; // 1230757/499995
         std::cout << "BEST COMPETITIVENESS POSSIBLE:  " << K << " = " << double(K) << std::endl;
         std::cout << "UPPER BOUND TO COMPETITIVENESS: " << U << " = " << double(U) << std::endl << std::endl;
         
+        phases.start("search");
         func g(U);
         K = g.competitiveness();
         std::cout << "DOUBLE CHECK: " << K << " = " << double(K) << ", " << g.size() << " custom values, " << g.offset() << " offset" << std::endl;
-        K = double_check(g, L);
+        phases.start("check");
+        K = fast_check(g, L);
+        // the exact reference sweep certifies the same value on a prefix
+        assert(fast_check(g, L/100) == double_check(g, L/100));
+        phases.stop();
         std::cout << "TRIPLE CHECK: " << K << " = " << double(K) << ", checked up to " << L << std::endl;
         std::cout << g << std::endl << std::endl;
     }
     {
         std::cout << "SIMPLER GOOD-ENOUGH FUNCTION" << std::endl;
         frac K(5,2);
+        phases.start("search");
         func g(K);
         K = g.competitiveness();
         std::cout << "DOUBLE CHECK: " << K << " = " << double(K) << ", " << g.size() << " custom values, " << g.offset() << " offset" << std::endl;
-        K = double_check(g, L);
+        phases.start("check");
+        K = fast_check(g, L);
+        // the exact reference sweep certifies the same value on a prefix
+        assert(fast_check(g, L/100) == double_check(g, L/100));
+        phases.stop();
         std::cout << "TRIPLE CHECK: " << K << " = " << double(K) << ", checked up to " << L << std::endl;
         std::cout << g << std::endl << std::endl;
     }
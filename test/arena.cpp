@@ -0,0 +1,59 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cpp/arena.hpp"
+
+
+TEST(ArenaTest, Monotonic) {
+    monotonic_arena a(64);
+    void* p = a.allocate(24, 8);
+    void* q = a.allocate(100, 16);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(q) % 16);
+    EXPECT_NE(p, q);
+    a.reset();
+    EXPECT_EQ(p, a.allocate(24, 8));
+}
+
+TEST(ArenaTest, PoolRecycles) {
+    pool_arena a(1 << 10, 1 << 8);
+    void* p = a.allocate(100, 8);
+    void* q = a.allocate(120, 8);
+    a.deallocate(p, 100);
+    // same size class (128 bytes)
+    EXPECT_EQ(p, a.allocate(70, 8));
+    a.deallocate(q, 120);
+    EXPECT_EQ(q, a.allocate(128, 8));
+    size_t c = a.capacity();
+    // large chunks are left to the system
+    void* r = a.allocate(1000, 8);
+    EXPECT_EQ(c, a.capacity());
+    a.deallocate(r, 1000);
+}
+
+TEST(ArenaTest, PoolContainers) {
+    pool_arena a;
+    std::vector<int, arena_allocator<int, pool_arena>> v(a);
+    std::deque<int, arena_allocator<int, pool_arena>> d(a);
+    size_t c = 0;
+    for (int k = 0; k < 3; ++k) {
+        for (int i = 0; i < 100000; ++i) {
+            v.push_back(i);
+            d.push_back(i);
+            if (i % 2) d.pop_front();
+        }
+        // memory is reused across resets
+        if (k == 0) c = a.capacity();
+        EXPECT_EQ(c, a.capacity());
+        v.clear();
+        d.clear();
+        v.shrink_to_fit();
+        d.shrink_to_fit();
+        a.reset();
+    }
+    EXPECT_EQ(0u, v.size());
+}
@@ -0,0 +1,62 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+#include "fcpp/event_list.hpp"
+
+using namespace fcpp;
+
+
+TEST(EventListTest, Removals) {
+    event_list e("50:0 70:L 60:3 90:L");
+    EXPECT_EQ(4u, e.events().size());
+    EXPECT_EQ(0u, e.occurred(10));
+    EXPECT_EQ(2u, e.occurred(60));
+    EXPECT_EQ(4u, e.occurred(100));
+    EXPECT_EQ(0, e.time(0));
+    EXPECT_EQ(60, e.time(2));
+    EXPECT_EQ(0u, e.leader(0));
+    EXPECT_EQ(1u, e.leader(1));
+    EXPECT_EQ(1u, e.leader(2));
+    EXPECT_EQ(2u, e.leader(3));
+    EXPECT_EQ(4u, e.leader(4));
+    EXPECT_EQ(50, e.removal(0));
+    EXPECT_EQ(70, e.removal(1));
+    EXPECT_EQ(90, e.removal(2));
+    EXPECT_EQ(60, e.removal(3));
+    EXPECT_EQ(TIME_MAX, e.removal(4));
+    EXPECT_FALSE(e.partitioned(4));
+}
+
+TEST(EventListTest, Arrivals) {
+    event_list e("10:+2 20:+3");
+    size_t n = 10;
+    EXPECT_EQ(0, e.arrival(4, n));
+    EXPECT_EQ(10, e.arrival(5, n));
+    EXPECT_EQ(10, e.arrival(6, n));
+    EXPECT_EQ(20, e.arrival(7, n));
+    EXPECT_EQ(20, e.arrival(9, n));
+    EXPECT_FALSE(e.present(6, 5, n));
+    EXPECT_TRUE(e.present(6, 10, n));
+    EXPECT_EQ(7u, event_list("10:5 10:6").first_present(5, 15, n));
+    EXPECT_EQ(7u, e.first_present(5, 5, 7));
+}
+
+TEST(EventListTest, Partitions) {
+    event_list e("10:split 20:L 30:join");
+    EXPECT_FALSE(e.partitioned(0));
+    EXPECT_TRUE(e.partitioned(1));
+    EXPECT_TRUE(e.partitioned(2));
+    EXPECT_FALSE(e.partitioned(3));
+    EXPECT_EQ(1u, e.leader(2));
+}
+
+TEST(EventListTest, Shared) {
+    event_list e("10:0 20:L"), f("10:0 20:L");
+    EXPECT_EQ(&e.times(), &f.times());
+    EXPECT_NE(&e.times(), &event_list().times());
+    EXPECT_TRUE(event_list().times().empty());
+    EXPECT_THROW(event_list("10"), std::invalid_argument);
+}
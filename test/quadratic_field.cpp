@@ -0,0 +1,87 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cpp/quadratic_field.hpp"
+
+using q2 = quadratic_field<2>;
+using q3 = quadratic_field<3>;
+
+
+TEST(QuadraticFieldTest, Root) {
+    static_assert(q2::root > 1.41421356 and q2::root < 1.41421357, "√2 not constant-initialised");
+    EXPECT_DOUBLE_EQ(std::sqrt(2.0), q2::root);
+    EXPECT_DOUBLE_EQ(std::sqrt(3.0), q3::root);
+    EXPECT_DOUBLE_EQ(std::sqrt(1013.0), (quadratic_field<1013>::root));
+}
+
+TEST(QuadraticFieldTest, Reduce) {
+    q2 x(4, 6, -8);
+    EXPECT_EQ(-2, x.integral());
+    EXPECT_EQ(-3, x.irrational());
+    EXPECT_EQ(4, x.denominator());
+    q2 y(0, 5, 10);
+    EXPECT_EQ(0, y.integral());
+    EXPECT_EQ(1, y.irrational());
+    EXPECT_EQ(2, y.denominator());
+    EXPECT_EQ(q2(3, 1), q2(6, 2, 2));
+}
+
+TEST(QuadraticFieldTest, Sign) {
+    // 3 - 2√2 > 0, 2√2 - 3 < 0, 1 - √2 < 0, 3 - √3 > 0
+    EXPECT_GT(q2::sign(3, -2), 0);
+    EXPECT_LT(q2::sign(-3, 2), 0);
+    EXPECT_LT(q2::sign(1, -1), 0);
+    EXPECT_GT(q2::sign(-1, 1), 0);
+    EXPECT_GT(q3::sign(3, -1), 0);
+    EXPECT_LT(q3::sign(-3, 1), 0);
+    EXPECT_EQ(0, q2::sign(0, 0));
+    EXPECT_LT(q2(1, -1), 0);
+    EXPECT_GT(q2(3, -2), 0);
+}
+
+TEST(QuadraticFieldTest, Division) {
+    q2 x(1, 1), y(1, -1);
+    // (1+√2) / (1-√2) = -(3+2√2)
+    EXPECT_EQ(q2(-3, -2), x / y);
+    EXPECT_EQ(x, x / y * y);
+    q2 z(5, -3, 7);
+    EXPECT_EQ(z, z / x * x);
+    EXPECT_EQ(q2(1), z / z);
+    EXPECT_NEAR(double(z) / double(x), double(z / x), 1e-12);
+    q2 w = z;
+    w /= x;
+    EXPECT_EQ(z / x, w);
+}
+
+TEST(QuadraticFieldTest, Batch) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<long long> coef(-1000, 1000), den(1, 1000);
+    std::vector<q2> xs, ys;
+    for (int i = 0; i < 4000; ++i) {
+        q2 x(coef(gen), coef(gen), den(gen));
+        xs.push_back(x);
+        ys.push_back(i % 3 == 0 ? x : q2(coef(gen), coef(gen), den(gen)));
+    }
+    // Pell approximations p/q of √2, tying it within 1/(2√2 q²)
+    for (long long p = 1, q = 1; q < (1LL << 24); p += 2*q, q = p - q) {
+        xs.emplace_back(0, 1);
+        ys.emplace_back(p, 0, q);
+        xs.emplace_back(p, 0, q);
+        ys.emplace_back(0, q, q);
+    }
+    size_t n = xs.size();
+    std::vector<double> v(n);
+    std::vector<int> c(n);
+    evaluate(xs.data(), v.data(), n);
+    compare(xs.data(), ys.data(), c.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_DOUBLE_EQ(double(xs[i]), v[i]);
+        long long e = xs[i].compare(ys[i]);
+        EXPECT_EQ((e > 0) - (e < 0), c[i]) << xs[i] << " vs " << ys[i];
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright © 2020 Giorgio Audrito. All Rights Reserved.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cpp/shared_func.hpp"
+
+
+TEST(SharedFuncTest, Forwarding) {
+    func g(frac(5,2));
+    shared_func s(g);
+    shared_func::reader r(s);
+    for (int x = 0; x < 1000; ++x) {
+        EXPECT_EQ(g.dir(x), r.dir(x));
+        EXPECT_EQ(g.inv(x), r.inv(x));
+        EXPECT_EQ(g.recovery(x), r.recovery(x));
+    }
+    EXPECT_EQ(g.competitiveness(), r.competitiveness());
+}
+
+TEST(SharedFuncTest, Reclaim) {
+    func g0(frac(5,2)), g1(frac(13,5));
+    shared_func s(g0);
+    {
+        shared_func::reader r(s);
+        const func& g = r.acquire();
+        s.publish(g1);
+        s.reclaim();
+        // the version acquired is still protected
+        EXPECT_EQ(2u, s.versions());
+        EXPECT_EQ(g0.dir(100), g.dir(100));
+        r.release();
+        s.reclaim();
+        EXPECT_EQ(1u, s.versions());
+        EXPECT_EQ(g1.dir(100), r.acquire().dir(100));
+    }
+    s.publish(g0);
+    EXPECT_EQ(1u, s.versions());
+}
+
+TEST(SharedFuncTest, Concurrent) {
+    std::vector<func> gs = {func(frac(5,2)), func(frac(13,5))};
+    shared_func s(gs[0]);
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t)
+        readers.emplace_back([&](){
+            shared_func::reader r(s);
+            while (not stop) {
+                const func& g = r.acquire();
+                for (int x = 0; x < 100; ++x)
+                    if (g.dir(x) != gs[0].dir(x) and g.dir(x) != gs[1].dir(x)) ++errors;
+                r.release();
+            }
+        });
+    for (int i = 0; i < 1000; ++i) {
+        s.publish(gs[i % 2]);
+        s.reclaim();
+    }
+    stop = true;
+    for (std::thread& t : readers) t.join();
+    EXPECT_EQ(0, errors);
+    s.reclaim();
+    EXPECT_EQ(1u, s.versions());
+}